@@ -0,0 +1,76 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// activewindow.hpp: what threads of a run tell each other about their activity, while they run
+
+#if !defined(ACTIVEWINDOW_H)
+#define ACTIVEWINDOW_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <boost/timer/timer.hpp>
+
+// ActiveWindow is shared by all threads of a run, and by all processes of a group (it then lives
+// in shared memory, see ProcessGroup): it holds no pointer, only lock-free atomics.
+// It is reset by the executor before threads are released. The active window itself opens once
+// all threads have started recording, and closes as soon as one of them has finished:
+// threads tell whether each call falls in it as they go, without keeping their calls for later.
+class ActiveWindow
+{
+    std::atomic<std::int64_t> m_origin { 0 }; // steady clock, in ns: when the first thread started recording. 0 until then
+    std::atomic<size_t> m_threads { 0 };      // number of threads of the run, in all processes
+    std::atomic<size_t> m_started { 0 };      // number of threads that started recording
+    std::atomic<size_t> m_finished { 0 };     // number of threads that finished recording
+
+public:
+    // reset(): a run of threads starts. Unless restarted, the origin of the previous run is kept
+    inline void reset(size_t threads, bool restart) {
+	if(restart) {
+	    m_origin.store(0, std::memory_order_relaxed);
+	}
+	m_threads.store(threads, std::memory_order_relaxed);
+	m_started.store(0, std::memory_order_relaxed);
+	m_finished.store(0, std::memory_order_relaxed);
+    }
+
+    // start(): a thread starts recording, at started ns after epoch. Returns when the first thread of the run did,
+    // since epoch: intervals of time series are counted from there.
+    inline boost::timer::nanosecond_type start(std::chrono::steady_clock::time_point epoch, boost::timer::nanosecond_type started) {
+	const std::int64_t base = std::chrono::duration_cast<std::chrono::nanoseconds>(epoch.time_since_epoch()).count();
+	std::int64_t origin = 0;
+	m_started.fetch_add(1, std::memory_order_acq_rel);
+	if(m_origin.compare_exchange_strong(origin, base + started, std::memory_order_acq_rel)) {
+	    return started;
+	}
+	return origin - base;
+    }
+
+    // finish(): a thread finished recording
+    inline void finish() { m_finished.fetch_add(1, std::memory_order_acq_rel); }
+
+    // opened(): tells if all threads have started recording. A call starting then is in the window,
+    // unless closed() when it completes.
+    inline bool opened() const { return m_started.load(std::memory_order_relaxed) >= m_threads.load(std::memory_order_relaxed); }
+    inline bool closed() const { return m_finished.load(std::memory_order_relaxed) > 0; }
+};
+
+static_assert(std::atomic<std::int64_t>::is_always_lock_free, "active window requires lock-free atomics");
+static_assert(std::atomic<size_t>::is_always_lock_free, "active window requires lock-free atomics");
+
+#endif // ACTIVEWINDOW_H
@@ -0,0 +1,110 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// barrier.cpp: a reusable barrier, to start threads together
+
+#include <thread>
+#include <algorithm>
+#include "barrier.hpp"
+
+// relax(): tell the CPU we are spinning, so that it saves power and lets its sibling hyperthread run
+static inline void relax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+
+void Barrier::reset(size_t parties, size_t contenders)
+{
+    std::lock_guard<std::mutex> lck(m_mtx);
+    m_parties = parties;
+    m_arrived = 0;
+    m_spinning = std::max(parties, contenders) <= std::thread::hardware_concurrency();
+}
+
+
+// release(): open the barrier. must be called with the lock held.
+void Barrier::release()
+{
+    m_released = std::chrono::steady_clock::now();
+    m_arrived = 0;
+    m_generation.fetch_add(1, std::memory_order_release); // publishes m_released to spinning threads
+    m_cond.notify_all();
+}
+
+
+// arrived(): count one more arrival. the lock must be held.
+void Barrier::arrived()
+{
+    if(++m_arrived + 1 == m_parties) {
+	m_arrivals.notify_all();
+    }
+}
+
+
+std::chrono::steady_clock::time_point Barrier::arrive_and_wait()
+{
+    size_t generation;
+
+    {
+	std::lock_guard<std::mutex> lck(m_mtx);
+	generation = m_generation.load(std::memory_order_relaxed);
+	arrived();
+
+	if(m_arrived >= m_parties) {
+	    release();
+	    return m_released;
+	}
+    }
+
+    auto opened = [this, generation] { return m_generation.load(std::memory_order_acquire) != generation; };
+
+    if(m_spinning) {
+	// each waiting thread has a CPU of its own: it spins however long the others take to arrive
+	while(!opened()) {
+	    relax();
+	}
+    } else {
+	std::unique_lock<std::mutex> lck(m_mtx);
+	m_cond.wait(lck, opened);
+    }
+
+    return m_released;
+}
+
+
+void Barrier::arrive()
+{
+    std::lock_guard<std::mutex> lck(m_mtx);
+    arrived();
+
+    if(m_arrived >= m_parties) {
+	release();
+    }
+}
+
+
+void Barrier::await_others()
+{
+    std::unique_lock<std::mutex> lck(m_mtx);
+    m_arrivals.wait(lck, [this] { return m_arrived + 1 >= m_parties; });
+}
@@ -0,0 +1,68 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// barrier.hpp: a reusable barrier, to start threads together
+
+#if !defined(BARRIER_H)
+#define BARRIER_H
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+// waiting threads spin on the barrier generation until it opens, as long as there are enough CPUs for all of them
+// to spin. Otherwise, they block on a condition variable (i.e. a futex on Linux). Waking up from a futex takes
+// tens of microseconds, and varies from one thread to another: spinning releases threads almost at the same time.
+class Barrier
+{
+    std::mutex m_mtx;
+    std::condition_variable m_cond;
+    std::condition_variable m_arrivals; // notified when all parties but one have arrived
+    size_t m_parties { 0 };	// number of threads expected at the barrier
+    size_t m_arrived { 0 };	// number of threads arrived so far
+    std::atomic<size_t> m_generation { 0 }; // incremented each time the barrier opens
+    std::chrono::steady_clock::time_point m_released; // when the barrier last opened
+    bool m_spinning { false };	// waiting threads spin rather than block
+
+    void release();
+    void arrived();
+
+public:
+    Barrier() = default;
+
+    Barrier( const Barrier &) = delete;
+    Barrier& operator=( const Barrier &) = delete;
+
+    // reset(): arm the barrier for a number of parties. Must not be called while threads are waiting.
+    // contenders is the number of threads waiting at the same time, other processes included (by default, the parties):
+    // spinning is disabled when there are more contenders than CPUs.
+    void reset(size_t parties, size_t contenders = 0);
+
+    // arrive_and_wait(): block until all parties have arrived, and return when the barrier opened
+    std::chrono::steady_clock::time_point arrive_and_wait();
+
+    // arrive(): count as arrived, without waiting (e.g. when a thread has failed before reaching the barrier)
+    void arrive();
+
+    // await_others(): block until all other parties have arrived, without arriving.
+    // the caller is then the last party, e.g. to synchronize with other processes before opening the barrier.
+    void await_others();
+};
+
+#endif // BARRIER_H
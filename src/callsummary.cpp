@@ -0,0 +1,73 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// callsummary.cpp: calls of a thread, summarized as they complete rather than recorded one by one
+
+#include <algorithm>
+#include "callsummary.hpp"
+
+
+moments_t &moments_t::operator+=(const moments_t &other)
+{
+    if(other.count == 0) {
+	return *this;
+    }
+
+    const double total = static_cast<double>(count + other.count);
+    const double delta = other.mean - mean;
+
+    m2 += other.m2 + delta * delta * count * other.count / total;
+    mean += delta * other.count / total;
+    count += other.count;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    sum += other.sum;
+
+    return *this;
+}
+
+
+latency_summary_t &latency_summary_t::operator+=(const latency_summary_t &other)
+{
+    moments += other.moments;
+    histogram.merge(other.histogram);
+
+    return *this;
+}
+
+
+call_summary_t &call_summary_t::operator+=(const call_summary_t &other)
+{
+    latency += other.latency;
+    deadline_met += other.deadline_met;
+    errors += other.errors;
+    for(auto [code, count]: other.error_codes) {
+	error_codes[code] += count;
+    }
+    retries += other.retries;
+    retried += other.retried;
+    retry_latency += other.retry_latency;
+    if(slots.size() < other.slots.size()) {
+	slots.resize(other.slots.size());
+    }
+    for(size_t s=0; s<other.slots.size(); s++) {
+	slots[s] += other.slots[s];
+    }
+
+    return *this;
+}
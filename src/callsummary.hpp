@@ -0,0 +1,84 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// callsummary.hpp: calls of a thread, summarized as they complete rather than recorded one by one
+
+#if !defined(CALLSUMMARY_H)
+#define CALLSUMMARY_H
+
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <limits>
+#include "histogram.hpp"
+
+// moments_t: count, mean, variance, extrema and sum of values, updated one value at a time
+// (Welford's method), and merged with the moments of other values (Chan's method)
+struct moments_t {
+    size_t count { 0 };
+    double mean { 0.0 };
+    double m2 { 0.0 };		// sum of squared deviations from the mean
+    double min { std::numeric_limits<double>::infinity() };
+    double max { -std::numeric_limits<double>::infinity() };
+    double sum { 0.0 };
+
+    inline void add(double value) {
+	count++;
+	const double delta = value - mean;
+	mean += delta / count;
+	m2 += delta * (value - mean);
+	min = value < min ? value : min;
+	max = value > max ? value : max;
+	sum += value;
+    }
+
+    // variance(): the sample variance, 0 with less than two values
+    inline double variance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+
+    moments_t &operator+=(const moments_t &other);
+};
+
+// latency_summary_t: moments and histogram of latencies, in ns
+struct latency_summary_t {
+    moments_t moments;
+    LatencyHistogram histogram;
+
+    inline void record(std::int64_t latency) {
+	moments.add(static_cast<double>(latency));
+	histogram.record(latency);
+    }
+
+    latency_summary_t &operator+=(const latency_summary_t &other);
+};
+
+// call_summary_t: what the calls of a thread add up to, as far as results are concerned.
+// Times are in ns.
+struct call_summary_t {
+    latency_summary_t latency;	// successful calls
+    size_t deadline_met { 0 };	// with a deadline: successful calls completed within it
+    moments_t errors;		// when errors are tolerated: latency of failed calls
+    std::map<int, size_t> error_codes; // when errors are tolerated: failed calls, per return code
+    moments_t retries;		// with a retry policy: retries of successful calls
+    size_t retried { 0 };	// with a retry policy: successful calls retried at least once
+    moments_t retry_latency;	// with a retry policy: time spent by successful calls before their last attempt
+    std::vector<latency_summary_t> slots; // with a router: successful calls, per slot
+
+    call_summary_t &operator+=(const call_summary_t &other);
+};
+
+#endif // CALLSUMMARY_H
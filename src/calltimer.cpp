@@ -0,0 +1,90 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// calltimer.cpp: a lightweight wall clock timer, to time PKCS#11 calls
+
+#include <thread>
+#include <sstream>
+#include <iomanip>
+#include "calltimer.hpp"
+
+#if defined(HAVE_CPUID_H)
+#include <cpuid.h>
+#endif
+
+CallTimer::Clock CallTimer::s_clock = CallTimer::Clock::steady;
+double CallTimer::s_ns_per_tick = 1.0;
+
+// invariant_tsc(): tells if the time stamp counter ticks at a constant rate, whatever the power state of the core
+static bool invariant_tsc()
+{
+#if defined(HAVE_CPUID_H) && defined(HAVE_X86INTRIN_H)
+    unsigned int eax, ebx, ecx, edx;
+
+    if(__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+	return (edx & (1 << 8)) != 0;
+    }
+#endif
+    return false;
+}
+
+
+void CallTimer::use(const std::string &name)
+{
+    if(name == "steady") {
+	s_clock = Clock::steady;
+    } else if(name == "monotonic-raw") {
+	s_clock = Clock::monotonic_raw;
+    } else if(name == "tsc") {
+	if(!invariant_tsc()) {
+	    throw CallTimerException("the time stamp counter is not invariant, or not available on this platform");
+	}
+	s_clock = Clock::tsc;
+
+	// calibrate the counter against the steady clock, over a period long enough
+	// for the error on reading the steady clock to be negligible
+	constexpr auto period = std::chrono::milliseconds(50);
+	auto t0 = std::chrono::steady_clock::now();
+	auto c0 = now();
+	std::this_thread::sleep_for(period);
+	auto t1 = std::chrono::steady_clock::now();
+	auto c1 = now();
+
+	s_ns_per_tick = std::chrono::duration<double, std::nano>(t1 - t0).count() / (c1 - c0);
+    } else {
+	throw CallTimerException("timer must be steady, monotonic-raw or tsc, got " + name);
+    }
+}
+
+
+std::string CallTimer::clock()
+{
+    switch(s_clock) {
+    case Clock::tsc: {
+	std::ostringstream os;
+	os << "tsc (" << std::fixed << std::setprecision(2) << 1.0 / s_ns_per_tick << " GHz)";
+	return os.str();
+    }
+
+    case Clock::monotonic_raw:
+	return "monotonic-raw";
+
+    default:
+	return "steady";
+    }
+}
@@ -0,0 +1,115 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// calltimer.hpp: a lightweight wall clock timer, to time PKCS#11 calls
+
+#if !defined(CALLTIMER_H)
+#define CALLTIMER_H
+
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+#include <time.h>
+#include "../config.h"
+
+#if defined(HAVE_X86INTRIN_H)
+#include <x86intrin.h>
+#endif
+
+struct CallTimerException : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+};
+
+// CallTimer measures wall time only: unlike boost::timer::cpu_timer, it does not query CPU times,
+// which would cost extra system calls on every iteration. The clock is chosen once for all timers,
+// before any measurement, among:
+// - "steady"	     : std::chrono::steady_clock
+// - "monotonic-raw" : CLOCK_MONOTONIC_RAW, not slewed by NTP
+// - "tsc"	     : the invariant time stamp counter of x86 processors, read with rdtscp, and calibrated at startup
+class CallTimer
+{
+public:
+    enum class Clock { steady, monotonic_raw, tsc };
+
+private:
+    static Clock s_clock;
+    static double s_ns_per_tick; // tsc only: calibrated duration of a tick
+
+    std::int64_t m_started { 0 }; // ticks, when the timer was started or resumed
+    std::int64_t m_elapsed { 0 }; // ticks, accumulated while the timer was running
+    bool m_running { false };
+
+public:
+    // use(): choose the clock of all timers, by name. For tsc, calibrates the counter
+    static void use(const std::string &name);
+
+    // clock(): a description of the clock in use, e.g. "tsc (2.90 GHz)"
+    static std::string clock();
+
+    // now(): read the clock in use, in ticks
+    static inline std::int64_t now() {
+	switch(s_clock) {
+#if defined(HAVE_X86INTRIN_H)
+	case Clock::tsc: {
+	    unsigned int aux;
+	    auto ticks = __rdtscp(&aux); // waits for previous instructions to complete
+	    _mm_lfence();		   // and keeps next ones from starting early
+	    return static_cast<std::int64_t>(ticks);
+	}
+#endif
+	case Clock::monotonic_raw: {
+	    struct timespec ts;
+	    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+	    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+	}
+
+	default:
+	    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+    }
+
+    // to_ns(): convert ticks to nanoseconds
+    static inline std::int64_t to_ns(std::int64_t ticks) {
+	return s_clock == Clock::tsc ? static_cast<std::int64_t>(ticks * s_ns_per_tick) : ticks;
+    }
+
+    // start(): reset the timer, and start it
+    inline void start() { m_elapsed = 0; m_running = true; m_started = now(); }
+
+    // stop(): stop the timer, keeping the time elapsed so far
+    inline void stop() {
+	if(m_running) {
+	    m_elapsed += now() - m_started;
+	    m_running = false;
+	}
+    }
+
+    // resume(): start the timer again, without resetting it
+    inline void resume() {
+	if(!m_running) {
+	    m_running = true;
+	    m_started = now();
+	}
+    }
+
+    // elapsed(): time elapsed while the timer was running, in nanoseconds
+    inline std::int64_t elapsed() const { return to_ns(m_running ? m_elapsed + now() - m_started : m_elapsed); }
+};
+
+#endif // CALLTIMER_H
@@ -0,0 +1,89 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// cpuusage.cpp: CPU time and scheduling statistics of the calling thread
+
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include "cpuusage.hpp"
+
+cpu_usage_t &cpu_usage_t::operator+=(const cpu_usage_t &other)
+{
+    user += other.user;
+    system += other.system;
+    oncpu += other.oncpu;
+    runqueue += other.runqueue;
+    voluntary += other.voluntary;
+    involuntary += other.involuntary;
+    calls += other.calls;
+    rusage = rusage && other.rusage;
+    schedstat = schedstat && other.schedstat;
+
+    return *this;
+}
+
+
+cpu_usage_t sample_cpu_usage()
+{
+    cpu_usage_t rv;
+
+#if defined(RUSAGE_THREAD)
+    struct rusage usage;
+
+    if(getrusage(RUSAGE_THREAD, &usage) == 0) {
+	rv.user = (static_cast<nanosecond_type>(usage.ru_utime.tv_sec) * 1000000 + usage.ru_utime.tv_usec) * 1000;
+	rv.system = (static_cast<nanosecond_type>(usage.ru_stime.tv_sec) * 1000000 + usage.ru_stime.tv_usec) * 1000;
+	rv.voluntary = static_cast<size_t>(usage.ru_nvcsw);
+	rv.involuntary = static_cast<size_t>(usage.ru_nivcsw);
+	rv.rusage = true;
+    }
+#endif
+
+#if defined(SYS_gettid)
+    // schedstat holds the time spent on CPU, the time spent waiting on a run queue (both in ns),
+    // and the number of time slices. It requires a kernel built with CONFIG_SCHEDSTATS.
+    std::ifstream schedstat("/proc/self/task/" + std::to_string(syscall(SYS_gettid)) + "/schedstat");
+
+    if(schedstat >> rv.oncpu >> rv.runqueue) {
+	rv.schedstat = true;
+    }
+#endif
+
+    return rv;
+}
+
+
+cpu_usage_t operator-(const cpu_usage_t &end, const cpu_usage_t &start)
+{
+    cpu_usage_t rv;
+
+    rv.user = end.user - start.user;
+    rv.system = end.system - start.system;
+    rv.oncpu = end.oncpu - start.oncpu;
+    rv.runqueue = end.runqueue - start.runqueue;
+    rv.voluntary = end.voluntary - start.voluntary;
+    rv.involuntary = end.involuntary - start.involuntary;
+    rv.rusage = end.rusage && start.rusage;
+    rv.schedstat = end.schedstat && start.schedstat;
+
+    return rv;
+}
@@ -0,0 +1,52 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// cpuusage.hpp: CPU time and scheduling statistics of the calling thread
+
+#if !defined(CPUUSAGE_H)
+#define CPUUSAGE_H
+
+#include <cstddef>
+#include <boost/timer/timer.hpp>
+
+using boost::timer::nanosecond_type;
+
+// cpu_usage_t: CPU time consumed by a thread, and how it was scheduled.
+// user and system times, and context switches come from getrusage(RUSAGE_THREAD);
+// time spent on CPU and waiting on a run queue come from /proc/self/task/<tid>/schedstat.
+struct cpu_usage_t {
+    nanosecond_type user { 0 };	// CPU time in user mode
+    nanosecond_type system { 0 };	// CPU time in kernel mode
+    nanosecond_type oncpu { 0 };	// time spent running on a CPU
+    nanosecond_type runqueue { 0 };	// time spent runnable, waiting for a CPU
+    size_t voluntary { 0 };	// voluntary context switches, e.g. waiting for the token
+    size_t involuntary { 0 };	// involuntary context switches, i.e. preemptions
+    size_t calls { 0 };		// number of calls made while sampling
+    bool rusage { false };	// tells if user, system times and context switches are available
+    bool schedstat { false };	// tells if on-CPU and run queue times are available
+
+    cpu_usage_t &operator+=(const cpu_usage_t &other);
+};
+
+// sample_cpu_usage(): CPU usage of the calling thread since it started
+cpu_usage_t sample_cpu_usage();
+
+// operator-(): CPU usage between two samples of the same thread
+cpu_usage_t operator-(const cpu_usage_t &end, const cpu_usage_t &start);
+
+#endif // CPUUSAGE_H
@@ -0,0 +1,70 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// duration.cpp: parse durations given on the command line, e.g. "30s", "500ms" or "2m"
+
+#include <cstdlib>
+#include <cmath>
+#include "duration.hpp"
+#include "stringhash.hpp"
+
+using namespace stringhash;
+
+std::chrono::nanoseconds parse_duration(const std::string &duration)
+{
+    char *unit = nullptr;
+    double value = strtod(duration.c_str(), &unit);
+    double factor;
+
+    if(unit == duration.c_str() || !std::isfinite(value) || value < 0.0) {
+	throw DurationException("invalid duration: " + duration);
+    }
+
+    switch(stringhash::hash(unit)) {
+    case ""_hash:
+    case "s"_hash:
+	factor = 1e9;
+	break;
+
+    case "h"_hash:
+	factor = 3600e9;
+	break;
+
+    case "m"_hash:
+    case "min"_hash:
+	factor = 60e9;
+	break;
+
+    case "ms"_hash:
+	factor = 1e6;
+	break;
+
+    case "us"_hash:
+	factor = 1e3;
+	break;
+
+    case "ns"_hash:
+	factor = 1.0;
+	break;
+
+    default:
+	throw DurationException("invalid duration unit in: " + duration);
+    }
+
+    return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(value * factor));
+}
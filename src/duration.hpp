@@ -0,0 +1,37 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// duration.hpp: parse durations given on the command line, e.g. "30s", "500ms" or "2m"
+
+#if !defined(DURATION_H)
+#define DURATION_H
+
+#include <chrono>
+#include <string>
+#include <stdexcept>
+
+struct DurationException : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+};
+
+// parse_duration(): converts a string made of a number and a unit (h, m, s, ms, us or ns)
+// into a duration. When the unit is omitted, seconds are assumed.
+// throws DurationException if the string cannot be parsed.
+std::chrono::nanoseconds parse_duration(const std::string &duration);
+
+#endif // DURATION_H
@@ -16,6 +16,7 @@
 // limitations under the License.
 //
 
+#include <cstdlib>
 #include <botan/p11.h>
 #include "errorcodes.hpp"
 
@@ -302,3 +303,25 @@ const std::string errorcode(int rc) {
 	return std::to_string(rc);
     }
 }
+
+
+std::optional<int> errorcode_value(const std::string &name)
+{
+    if(name.rfind("CKR_", 0) != 0) {
+	char *end = nullptr;
+	auto rc = strtoul(name.c_str(), &end, 0);
+	if(name.empty() || *end != '\0') {
+	    return std::nullopt;
+	}
+	return static_cast<int>(rc);
+    }
+
+    // standard return codes are all below 0x400
+    for(int rc=0; rc<0x400; rc++) {
+	if(errorcode(rc) == name) {
+	    return rc;
+	}
+    }
+
+    return std::nullopt;
+}
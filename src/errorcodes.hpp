@@ -20,8 +20,12 @@
 #define ERRORCODES_H
 
 #include <string>
+#include <optional>
 #include "../config.h"
 
 const std::string errorcode(int rc);
 
+// errorcode_value(): the return code named by a CKR_ constant, or given as a number (e.g. 0x30), if any
+std::optional<int> errorcode_value(const std::string &name);
+
 #endif // ERRORCODES_H
@@ -22,9 +22,12 @@
 #include <iomanip>
 #include <ios>
 #include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <map>
+#include <limits>
 #include <thread>
-#include <mutex>
-#include <condition_variable>
+#include <chrono>
 #include <future>
 #include <functional>
 #include <utility>
@@ -44,227 +47,2430 @@
 #include "p11benchmark.hpp"
 #include "measure.hpp"
 #include "executor.hpp"
+#include "usl.hpp"
+#include "p11noop.hpp"
 
-// thread sync objects
-std::mutex greenlight_mtx;
-std::condition_variable greenlight_cond;
-bool greenlight = false;
+namespace bacc = boost::accumulators;
+constexpr double nano_to_milli = 1000000.0 ;
+
+// helper functions for ConsoleTable conversion of items to string
+static std::string d2s(double arg, int precision=-1)
+{
+    std::ostringstream stream;
+    if(precision>=0) stream << std::setprecision(precision);
+    stream << arg;
+    return stream.str();
+}
+
+static std::string i2s(long arg)
+{
+    std::ostringstream stream;
+    stream << arg;
+    return stream.str();
+}
+
+// percentile(): returns the p-th percentile (0<p<=1) of samples, using the nearest rank method.
+// Note that samples are partially reordered.
+static double percentile(std::vector<double> &samples, double p)
+{
+    if(samples.empty()) {
+	return 0.0;
+    }
+
+    size_t rank = static_cast<size_t>(std::ceil(p * samples.size()));
+    auto nth = samples.begin() + (rank > 0 ? rank - 1 : 0);
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+// percentile_relerr(): relative half-width of the 95% confidence interval on the p-th percentile of samples.
+// the number of samples below the percentile follows a binomial distribution, which gives the ranks bounding the interval.
+// Note that samples are partially reordered.
+static double percentile_relerr(std::vector<double> &samples, double p)
+{
+    const double n = samples.size();
+    const double half = 2 * std::sqrt(n * p * (1 - p));
+
+    // the interval must be within the samples, otherwise there are not enough of them
+    if(n < 2 || n * p - half < 1 || n * p + half > n) {
+	return std::numeric_limits<double>::infinity();
+    }
+
+    auto value = percentile(samples, p);
+    auto lower = percentile(samples, (n * p - half) / n);
+    auto upper = percentile(samples, (n * p + half) / n);
+
+    return value > 0.0 ? (upper - lower) / 2 / value : std::numeric_limits<double>::infinity();
+}
+
+// percentile_relerr(): same, from a latency histogram
+static double percentile_relerr(const LatencyHistogram &histogram, double p)
+{
+    const double n = histogram.count();
+    const double half = 2 * std::sqrt(n * p * (1 - p));
+
+    if(n < 2 || n * p - half < 1 || n * p + half > n) {
+	return std::numeric_limits<double>::infinity();
+    }
+
+    double value = histogram.percentile(p);
+    double lower = histogram.percentile((n * p - half) / n);
+    double upper = histogram.percentile((n * p + half) / n);
+
+    return value > 0.0 ? (upper - lower) / 2 / value : std::numeric_limits<double>::infinity();
+}
+
+// average(): the mean of samples, with its error (k=2), topped to epsilon
+static Measure<> average(const std::vector<double> &samples, double epsilon, const std::string &unit)
+{
+    bacc::accumulator_set< double, bacc::stats< bacc::tag::mean, bacc::tag::variance > > acc;
+
+    for(auto sample: samples) {
+	acc(sample);
+    }
+
+    auto n = samples.size();
+    auto error = n > 1 ? std::sqrt(bacc::variance(acc) / (n - 1)) * 2 : epsilon;
+
+    return Measure<>(n > 0 ? bacc::mean(acc) : 0.0, std::max(error, epsilon), unit);
+}
+
+// average(): same, from the moments of values, divided by scale
+static Measure<> average(const moments_t &moments, double scale, double epsilon, const std::string &unit)
+{
+    auto n = moments.count;
+    auto error = n > 1 ? std::sqrt(moments.variance() / n) * 2 / scale : epsilon;
+
+    return Measure<>(moments.mean / scale, std::max(error, epsilon), unit);
+}
+
+// print_facts(): display test case facts on console
+static void print_facts(const std::string &title, std::vector<fact_row_t> &fact_rows)
+{
+    ConsoleTable facts { "property", "value" };
+    facts.setStyle(1);
+
+    for(auto &row: fact_rows) {
+	facts += { std::get<0>(row), std::get<2>(row) };
+    }
+
+    std::cout << title << '\n'
+	      << "================================================================================\n"
+	      << "Test case facts:\n"
+	      << facts << std::endl;
+}
+
+static void print_facts(P11Benchmark &benchmark, std::vector<fact_row_t> &fact_rows)
+{
+    print_facts(benchmark.name() + " with key " + benchmark.label(), fact_rows);
+}
+
+// recorded(): the number of successful iterations recorded by a thread, kept one by one or summarized
+static size_t recorded(const benchmark_result_t &elapsed)
+{
+    return elapsed.records.size() + elapsed.in_window.latency.moments.count + elapsed.outside.latency.moments.count;
+}
+
+// iteration_facts(): in duration-based and adaptive runs, build facts about the number of iterations actually recorded
+static std::vector<fact_row_t> iteration_facts(const std::vector<benchmark_result_t> &elapsed_time_array)
+{
+    size_t total = 0;
+    size_t minimum = std::numeric_limits<size_t>::max();
+    size_t maximum = 0;
+
+    for(auto &elapsed: elapsed_time_array) {
+	auto count = recorded(elapsed);
+	total += count;
+	minimum = std::min(minimum, count);
+	maximum = std::max(maximum, count);
+    }
+
+    return std::vector<fact_row_t> {
+	{ "iterations/thread, minimum", "iterations.thread.minimum", i2s(minimum) },
+	{ "iterations/thread, maximum", "iterations.thread.maximum", i2s(maximum) },
+	{ "total of iterations", "total iterations", i2s(total) }
+    };
+}
+
+// warmup_facts(): with automatic skip, build facts about the warm-up detected on each thread.
+// the warm-up time is the time taken by the iterations detected as warm-up, and its cost is the
+// part of it in excess of what the same iterations would have taken in the steady state.
+static std::vector<fact_row_t> warmup_facts(const std::vector<benchmark_result_t> &elapsed_time_array)
+{
+    size_t steady = 0;
+    size_t truncation_max = 0;
+    size_t executed_max = 0;
+    double truncation_sum = 0.0;
+    double time_sum = 0.0;
+    double cost_sum = 0.0;
+    double first_sum = 0.0;
+    const auto numthreads = elapsed_time_array.size();
+
+    for(auto &elapsed: elapsed_time_array) {
+	auto &warmup = elapsed.warmup;
+	auto truncation = std::min(elapsed.truncation, warmup.size());
+
+	steady += elapsed.steady ? 1 : 0;
+	truncation_max = std::max(truncation_max, truncation);
+	executed_max = std::max(executed_max, warmup.size());
+	truncation_sum += truncation;
+
+	if(warmup.empty()) {
+	    continue;
+	}
+
+	// the steady state latency is estimated from the iterations following the warm-up
+	auto time = std::accumulate(warmup.begin(), warmup.begin() + truncation, 0.0);
+	auto rest = warmup.size() - truncation;
+	auto steady_latency = rest > 0 ? std::accumulate(warmup.begin() + truncation, warmup.end(), 0.0) / rest : 0.0;
+
+	time_sum += time;
+	cost_sum += rest > 0 ? time - truncation * steady_latency : 0.0;
+	first_sum += warmup.front();
+    }
+
+    return std::vector<fact_row_t> {
+	{ "warm-up detected", "warmup.detected", i2s(steady) + '/' + i2s(numthreads) + " threads" },
+	{ "warm-up iterations/thread, average", "warmup.iterations.average", d2s(truncation_sum / numthreads) },
+	{ "warm-up iterations/thread, maximum", "warmup.iterations.maximum", i2s(truncation_max) },
+	{ "iterations run before recording/thread, maximum", "warmup.executed", i2s(executed_max) },
+	{ "first call latency, average (ms)", "warmup.first", d2s(first_sum / numthreads / nano_to_milli) },
+	{ "warm-up time/thread, average (ms)", "warmup.time", d2s(time_sum / numthreads / nano_to_milli) },
+	{ "warm-up cost/thread, average (ms)", "warmup.cost", d2s(cost_sum / numthreads / nano_to_milli) }
+    };
+}
+
+// print_iterations(): display facts about the number of iterations recorded
+static void print_iterations(std::vector<fact_row_t> &iteration_rows)
+{
+    ConsoleTable iterations { "property", "value" };
+    iterations.setStyle(1);
+
+    for(auto &row: iteration_rows) {
+	iterations += { std::get<0>(row), std::get<2>(row) };
+    }
+
+    std::cout << "Test case iterations:\n" << iterations << std::endl;
+}
+
+// active_window(): the window in which all threads were recording iterations, i.e. from the latest start to the earliest end
+static std::pair<nanosecond_type, nanosecond_type> active_window(const std::vector<benchmark_result_t> &elapsed_time_array)
+{
+    nanosecond_type window_start = 0;
+    nanosecond_type window_end = std::numeric_limits<nanosecond_type>::max();
+
+    for(auto &elapsed: elapsed_time_array) {
+	window_start = std::max(window_start, elapsed.started);
+	window_end = std::min(window_end, elapsed.finished);
+    }
+
+    return { window_start, window_end };
+}
+
+// windowed(): in closed loop, statistics are computed only over iterations executed while all threads were active:
+// threads do not leave the start line nor finish at the same time, and iterations of a thread running
+// with fewer competitors than the others would flatter latency, and thus TPS.
+// in open loop, the load is set by the schedule, and all iterations are kept.
+// if the window is too short to hold iterations, we fall back to all iterations.
+static bool windowed(const std::vector<benchmark_result_t> &elapsed_time_array, const ExecutionPlan &plan)
+{
+    auto [window_start, window_end] = active_window(elapsed_time_array);
+
+    if(plan.open_loop() || elapsed_time_array.size() < 2 || window_end <= window_start) {
+	return false;
+    }
+
+    size_t count = 0;
+    for(auto &elapsed: elapsed_time_array) {
+	// summarized iterations were told apart as threads ran, see ActiveWindow
+	count += elapsed.in_window.latency.moments.count;
+	for(size_t i=0; i<elapsed.records.size() && i<elapsed.timestamps.size(); i++) {
+	    count += elapsed.timestamps[i] - elapsed.records[i] >= window_start && elapsed.timestamps[i] <= window_end ? 1 : 0;
+	}
+    }
+
+    return count > 1;
+}
+
+// summarized(): with a histogram, the summary of iterations of all threads taken into account,
+// i.e. those within the active window when windowed
+static call_summary_t summarized(const std::vector<benchmark_result_t> &elapsed_time_array, bool windowed)
+{
+    call_summary_t rv;
+
+    for(auto &elapsed: elapsed_time_array) {
+	rv += elapsed.in_window;
+	if(!windowed) {
+	    rv += elapsed.outside;
+	}
+    }
+
+    return rv;
+}
+
+// merge_chunk(): in adaptive runs, append the iterations of a chunk to those of previous chunks, thread by thread.
+// the chunk timeline is shifted by offset, so that chunks follow each other.
+// when windowed, only iterations of the chunk executed while all threads were active are kept, see results().
+// the same goes for summarized iterations, told apart as threads ran.
+// time series intervals are merged as they are, as chunks share the origin of the first one (see adaptive_run()).
+static void merge_chunk(std::vector<benchmark_result_t> &merged, const std::vector<benchmark_result_t> &chunk, nanosecond_type offset, bool windowed)
+{
+    auto [window_start, window_end] = active_window(chunk);
+    windowed = windowed && window_end > window_start;
+    const bool first = merged.empty();
+
+    if(first) {
+	merged.resize(chunk.size());
+	for(size_t th=0; th<chunk.size(); th++) {
+	    merged[th].released = chunk[th].released;
+	    merged[th].started = windowed ? window_start : chunk[th].started;
+	    // warm-up happens in the first chunk only
+	    merged[th].warmup = chunk[th].warmup;
+	    merged[th].truncation = chunk[th].truncation;
+	    merged[th].steady = chunk[th].steady;
+	    merged[th].cpu = chunk[th].cpu;
+	}
+    }
+
+    for(size_t th=0; th<chunk.size(); th++) {
+	auto &elapsed = chunk[th];
+
+	for(size_t i=0; i<elapsed.records.size() && i<elapsed.timestamps.size(); i++) {
+	    if(!windowed || (elapsed.timestamps[i] - elapsed.records[i] >= window_start && elapsed.timestamps[i] <= window_end)) {
+		merged[th].records.push_back(elapsed.records[i]);
+		merged[th].timestamps.push_back(elapsed.timestamps[i] + offset);
+		if(i < elapsed.slots.size()) {
+		    merged[th].slots.push_back(elapsed.slots[i]);
+		}
+		if(i < elapsed.retries.size()) {
+		    merged[th].retries.push_back(elapsed.retries[i]);
+		    merged[th].retried.push_back(elapsed.retried[i]);
+		}
+	    }
+	}
+
+	merged[th].reopened += elapsed.reopened;
+	merged[th].reopen_time += elapsed.reopen_time;
+	if(!first) {
+	    merged[th].cpu += elapsed.cpu;
+	}
+	merged[th].in_window += elapsed.in_window;
+	if(!windowed) {
+	    merged[th].outside += elapsed.outside;
+	}
+
+	if(!elapsed.series.intervals.empty()) {
+	    auto &series = merged[th].series;
+	    if(series.intervals.empty()) {
+		series.origin = elapsed.series.origin;
+	    }
+	    series.intervals.resize(std::max(series.intervals.size(), elapsed.series.intervals.size()));
+	    for(size_t i=0; i<elapsed.series.intervals.size(); i++) {
+		series.intervals[i].merge(elapsed.series.intervals[i]);
+	    }
+	    // the origin of the chunk is relative to its own start
+	    series.end = series.origin + elapsed.series.end - elapsed.series.origin;
+	}
+
+	for(size_t i=0; i<elapsed.errors.size(); i++) {
+	    if(!windowed || (elapsed.error_timestamps[i] - elapsed.errors[i] >= window_start && elapsed.error_timestamps[i] <= window_end)) {
+		merged[th].errors.push_back(elapsed.errors[i]);
+		merged[th].error_timestamps.push_back(elapsed.error_timestamps[i] + offset);
+		merged[th].error_codes.push_back(elapsed.error_codes[i]);
+	    }
+	}
+
+	merged[th].span += elapsed.span;
+	merged[th].finished = (windowed ? window_end : elapsed.finished) + offset;
+	if(elapsed.errcode != CKR_OK) {
+	    merged[th].errcode = elapsed.errcode;
+	}
+    }
+}
+
+// skew_rows(): how far apart threads left the start line, started and finished recording iterations,
+// and how long all threads were active together
+static std::vector<result_row_t> skew_rows(const std::vector<benchmark_result_t> &elapsed_time_array, double epsilon)
+{
+    // spread(): difference between the latest and the earliest value of a member, in ms
+    auto spread = [&elapsed_time_array] (nanosecond_type benchmark_result_t::*member) -> double {
+		      auto [lowest, highest] = std::minmax_element(elapsed_time_array.begin(), elapsed_time_array.end(),
+								   [member] (auto &a, auto &b) { return a.*member < b.*member; });
+		      return ((*highest).*member - (*lowest).*member) / nano_to_milli;
+		  };
+
+    auto [window_start, window_end] = active_window(elapsed_time_array);
+    auto window = window_end > window_start ? (window_end - window_start) / nano_to_milli : 0.0;
+
+    return std::vector<result_row_t> {
+	{ "start line skew", "skew.release", Measure<>(spread(&benchmark_result_t::released), epsilon, "ms") },
+	{ "start skew", "skew.start", Measure<>(spread(&benchmark_result_t::started), epsilon, "ms") },
+	{ "end skew", "skew.end", Measure<>(spread(&benchmark_result_t::finished), epsilon, "ms") },
+	{ "all threads active", "window.active", Measure<>(window, epsilon, "ms") }
+    };
+}
+
+// slot_rows(): with a router, break down calls, TPS and latency per slot.
+// the TPS of a slot is the global TPS, weighted by the share of calls it received.
+static std::vector<result_row_t> slot_rows(const std::vector<benchmark_result_t> &elapsed_time_array,
+					   const Router &router,
+					   double tps_global_val,
+					   double tps_global_err,
+					   double epsilon,
+					   const std::function<bool(const benchmark_result_t &, size_t)> &selected)
+{
+    std::vector<result_row_t> rv;
+    std::vector<std::vector<double> > samples(router.slots());
+    size_t total = 0;
+
+    for(auto &elapsed: elapsed_time_array) {
+	for(size_t i=0; i<elapsed.slots.size() && i<elapsed.records.size(); i++) {
+	    if(selected(elapsed, i)) {
+		samples[elapsed.slots[i]].push_back(elapsed.records[i]/nano_to_milli);
+		total++;
+	    }
+	}
+    }
+
+    for(size_t s=0; s<router.slots(); s++) {
+	const std::string label { "slot " + i2s(router.slot(s)) };
+	const std::string key { "slot." + i2s(router.slot(s)) };
+	const double share = total > 0 ? static_cast<double>(samples[s].size()) / total : 0.0;
+	// the share is a proportion: its error is binomial (k=2), and at least one call
+	const double share_err = total > 0 ? std::max( 2 * std::sqrt(share * (1 - share) / total), 1.0 / total ) : 0.0;
+
+	rv.emplace_back( label + ", share of calls", key + ".share", Measure<>(100 * share, 100 * share_err, "%") );
+	rv.emplace_back( label + ", TPS", key + ".tps", Measure<>(tps_global_val * share, tps_global_err * share, "Tnx/s") );
+	if(!samples[s].empty()) {
+	    rv.emplace_back( label + ", latency, average", key + ".latency.average", average(samples[s], epsilon, "ms") );
+	    rv.emplace_back( label + ", latency, 99th percentile", key + ".latency.p99", Measure<>(percentile(samples[s], 0.99), epsilon, "ms") );
+	}
+    }
+
+    return rv;
+}
+
+// slot_rows(): same, from the summary of calls. The percentile is known to the width of the sub-bucket holding it
+static std::vector<result_row_t> slot_rows(const call_summary_t &summary,
+					   const Router &router,
+					   double tps_global_val,
+					   double tps_global_err,
+					   double epsilon)
+{
+    std::vector<result_row_t> rv;
+    size_t total = 0;
+
+    for(auto &slot: summary.slots) {
+	total += slot.moments.count;
+    }
+
+    for(size_t s=0; s<router.slots(); s++) {
+	const std::string label { "slot " + i2s(router.slot(s)) };
+	const std::string key { "slot." + i2s(router.slot(s)) };
+	const size_t count = s < summary.slots.size() ? summary.slots[s].moments.count : 0;
+	const double share = total > 0 ? static_cast<double>(count) / total : 0.0;
+	// the share is a proportion: its error is binomial (k=2), and at least one call
+	const double share_err = total > 0 ? std::max( 2 * std::sqrt(share * (1 - share) / total), 1.0 / total ) : 0.0;
+
+	rv.emplace_back( label + ", share of calls", key + ".share", Measure<>(100 * share, 100 * share_err, "%") );
+	rv.emplace_back( label + ", TPS", key + ".tps", Measure<>(tps_global_val * share, tps_global_err * share, "Tnx/s") );
+	if(count > 0) {
+	    auto p99 = summary.slots[s].histogram.percentile(0.99);
+	    rv.emplace_back( label + ", latency, average", key + ".latency.average", average(summary.slots[s].moments, nano_to_milli, epsilon, "ms") );
+	    rv.emplace_back( label + ", latency, 99th percentile", key + ".latency.p99",
+			     Measure<>(p99 / nano_to_milli, std::max(LatencyHistogram::resolution(p99) / nano_to_milli, epsilon), "ms") );
+	}
+    }
+
+    return rv;
+}
+
+// deadline_rows(): with a deadline, the share of calls completed within it, and the goodput,
+// i.e. the TPS of calls completed within the deadline
+static std::vector<result_row_t> deadline_rows(size_t met, size_t total, double tps_global_val, double tps_global_err)
+{
+    const double share = total > 0 ? static_cast<double>(met) / total : 0.0;
+    // the share is a proportion: its error is binomial (k=2), and at least one call
+    const double share_err = total > 0 ? std::max( 2 * std::sqrt(share * (1 - share) / total), 1.0 / total ) : 0.0;
+    // errors on TPS and on share are independent, relative errors are added in quadrature
+    const double goodput = tps_global_val * share;
+    const double goodput_err = share > 0.0 && tps_global_val > 0.0
+	? goodput * std::hypot(tps_global_err / tps_global_val, share_err / share)
+	: tps_global_val * share_err;
+
+    return std::vector<result_row_t> {
+	{ "calls within deadline", "deadline.met", Measure<>(100 * share, 100 * share_err, "%") },
+	{ "goodput", "goodput.global", Measure<>(goodput, goodput_err, "Tnx/s") }
+    };
+}
+
+// error_rows(): when errors are tolerated, the share of failed calls and their rate, broken down per return code,
+// and the latency of failed calls. Failed calls happen at the rate of all calls, weighted by their share.
+static std::vector<result_row_t> error_rows(const call_summary_t &summary,
+					    size_t succeeded,
+					    double tps_global_val,
+					    double tps_global_err,
+					    double epsilon)
+{
+    std::vector<result_row_t> rv;
+    const size_t failed = summary.errors.count;
+
+    const size_t total = succeeded + failed;
+    const double calls_val = succeeded > 0 ? tps_global_val * total / succeeded : 0.0;
+    const double calls_err = succeeded > 0 ? tps_global_err * total / succeeded : 0.0;
+
+    // share(): the share of failed calls and its error, binomial (k=2), and at least one call
+    auto share = [total] (size_t count) -> std::pair<double, double> {
+		     const double p = total > 0 ? static_cast<double>(count) / total : 0.0;
+		     return { p, total > 0 ? std::max( 2 * std::sqrt(p * (1 - p) / total), 1.0 / total ) : 0.0 };
+		 };
+
+    auto [rate, rate_err] = share(failed);
+    const double tps = calls_val * rate;
+    const double tps_err = rate > 0.0 && calls_val > 0.0
+	? tps * std::hypot(calls_err / calls_val, rate_err / rate)
+	: calls_val * rate_err;
+
+    rv.emplace_back( "error rate", "errors.rate", Measure<>(100 * rate, 100 * rate_err, "%") );
+    rv.emplace_back( "error TPS", "errors.tps", Measure<>(tps, tps_err, "Tnx/s") );
+
+    for(auto [code, count]: summary.error_codes) {
+	auto [code_rate, code_rate_err] = share(count);
+	rv.emplace_back( "errors, " + errorcode(code), "errors." + errorcode(code), Measure<>(100 * code_rate, 100 * code_rate_err, "%") );
+    }
+
+    if(failed > 0) {
+	rv.emplace_back( "latency of failed calls, average", "errors.latency.average", average(summary.errors, nano_to_milli, epsilon, "ms") );
+	rv.emplace_back( "latency of failed calls, maximum", "errors.latency.maximum", Measure<>(summary.errors.max / nano_to_milli, epsilon, "ms") );
+    }
+
+    return rv;
+}
+
+// error_rows(): same, from the failed calls recorded by threads
+static std::vector<result_row_t> error_rows(const std::vector<benchmark_result_t> &elapsed_time_array,
+					    size_t succeeded,
+					    double tps_global_val,
+					    double tps_global_err,
+					    double epsilon,
+					    const std::function<bool(const benchmark_result_t &, size_t)> &selected)
+{
+    call_summary_t summary;
+
+    for(auto &elapsed: elapsed_time_array) {
+	for(size_t i=0; i<elapsed.errors.size(); i++) {
+	    if(selected(elapsed, i)) {
+		summary.error_codes[elapsed.error_codes[i]]++;
+		summary.errors.add(elapsed.errors[i]);
+	    }
+	}
+    }
+
+    return error_rows(summary, succeeded, tps_global_val, tps_global_err, epsilon);
+}
+
+// retry_rows(): with a retry policy, how often calls were retried, the latency retries added to calls,
+// and the time spent reopening sessions
+static std::vector<result_row_t> retry_rows(const std::vector<benchmark_result_t> &elapsed_time_array,
+					    const call_summary_t &summary,
+					    double epsilon)
+{
+    std::vector<result_row_t> rv;
+    size_t reopened = 0;
+    double reopen_time = 0.0;
+
+    for(auto &elapsed: elapsed_time_array) {
+	reopened += elapsed.reopened;
+	reopen_time += elapsed.reopen_time/nano_to_milli;
+    }
+
+    if(summary.retries.count == 0) {
+	return rv;
+    }
+
+    const size_t total = summary.retries.count;
+    const double share = static_cast<double>(summary.retried) / total;
+    // the share is a proportion: its error is binomial (k=2), and at least one call
+    const double share_err = std::max( 2 * std::sqrt(share * (1 - share) / total), 1.0 / total );
+
+    // retries are counted: their average is known to one call in all
+    rv.emplace_back( "retries per call, average", "retries.average", average(summary.retries, 1.0, 1.0 / total, "") );
+    rv.emplace_back( "retried calls", "retries.share", Measure<>(100 * share, 100 * share_err, "%") );
+    rv.emplace_back( "latency added by retries, average", "retries.latency.average", average(summary.retry_latency, nano_to_milli, epsilon, "ms") );
+    rv.emplace_back( "latency added by retries, maximum", "retries.latency.maximum",
+		     Measure<>(summary.retry_latency.max / nano_to_milli, epsilon, "ms") );
+    rv.emplace_back( "sessions reopened", "retries.reopened", Measure<>(reopened, 0.0, "") );
+    if(reopened > 0) {
+	rv.emplace_back( "session reopen time, average", "retries.reopen.average", Measure<>(reopen_time / reopened, epsilon, "ms") );
+    }
+
+    return rv;
+}
+
+// retry_rows(): same, from the calls recorded by threads
+static std::vector<result_row_t> retry_rows(const std::vector<benchmark_result_t> &elapsed_time_array,
+					    double epsilon,
+					    const std::function<bool(const benchmark_result_t &, size_t)> &selected)
+{
+    call_summary_t summary;
+
+    for(auto &elapsed: elapsed_time_array) {
+	for(size_t i=0; i<elapsed.retries.size() && i<elapsed.records.size(); i++) {
+	    if(selected(elapsed, i)) {
+		summary.retries.add(elapsed.retries[i]);
+		summary.retried += elapsed.retries[i] > 0 ? 1 : 0;
+		summary.retry_latency.add(elapsed.retried[i]);
+	    }
+	}
+    }
+
+    return retry_rows(elapsed_time_array, summary, epsilon);
+}
+
+// cpu_rows(): CPU time consumed by threads per call, in user and kernel mode, their context switches per call,
+// and the share of latency spent on CPU, or waiting for a CPU. Calls are those made while CPU usage was sampled,
+// i.e. all recorded iterations, whether they are kept for statistics or not.
+static std::vector<result_row_t> cpu_rows(const std::vector<benchmark_result_t> &elapsed_time_array)
+{
+    std::vector<result_row_t> rv;
+    cpu_usage_t total;
+    double latency = 0.0;	// time spent in calls, in ns
+
+    total.rusage = total.schedstat = true;
+
+    for(auto &elapsed: elapsed_time_array) {
+	total += elapsed.cpu;
+	latency += std::accumulate(elapsed.records.begin(), elapsed.records.end(), 0.0);
+	latency += std::accumulate(elapsed.errors.begin(), elapsed.errors.end(), 0.0);
+	for(auto summary: { &elapsed.in_window, &elapsed.outside }) {
+	    latency += summary->latency.moments.sum + summary->errors.sum;
+	}
+    }
+
+    if(total.calls == 0) {
+	return rv;
+    }
+
+    const double calls = total.calls;
+    const double samples = 2.0 * elapsed_time_array.size(); // each thread is sampled twice
+    // getrusage() gives times to the microsecond. schedstat gives them to the nanosecond, but sampling
+    // takes about a microsecond, which is accounted for. Each sample may count one context switch of its own.
+    const double time_err = samples / calls;
+    const double count_err = samples / calls;
+    const double share_err = 100 * samples * 1000 / latency;
+
+    if(total.rusage) {
+	rv.emplace_back( "CPU time per call, user", "cpu.user", Measure<>(total.user / calls / 1000, time_err, "us") );
+	rv.emplace_back( "CPU time per call, system", "cpu.system", Measure<>(total.system / calls / 1000, time_err, "us") );
+	rv.emplace_back( "CPU time per call, total", "cpu.total", Measure<>((total.user + total.system) / calls / 1000, 2 * time_err, "us") );
+	rv.emplace_back( "voluntary context switches per call", "cpu.switches.voluntary", Measure<>(total.voluntary / calls, count_err, "") );
+	rv.emplace_back( "involuntary context switches per call", "cpu.switches.involuntary", Measure<>(total.involuntary / calls, count_err, "") );
+    }
+
+    if(total.schedstat && latency > 0.0) {
+	// the rest of latency is spent off CPU, blocked, e.g. waiting for the token
+	rv.emplace_back( "run queue wait per call", "cpu.runqueue", Measure<>(total.runqueue / calls / 1000, time_err, "us") );
+	rv.emplace_back( "on-CPU share of latency", "cpu.share.oncpu", Measure<>(std::min(100.0, 100 * total.oncpu / latency), share_err, "%") );
+	rv.emplace_back( "run queue share of latency", "cpu.share.runqueue", Measure<>(std::min(100.0, 100 * total.runqueue / latency), share_err, "%") );
+    }
+
+    return rv;
+}
+
+// histogram_rows(): latency percentiles, up to the tail, from the histogram of all threads.
+// each is known to the width of the sub-bucket holding it, or to the timer resolution.
+static std::vector<result_row_t> histogram_rows(const LatencyHistogram &histogram, double epsilon)
+{
+    std::vector<result_row_t> rv;
+
+    if(histogram.count() == 0) {
+	return rv;
+    }
+
+    const std::vector<std::tuple<std::string, std::string, double> > percentiles {
+	{ "latency, median", "latency.p50", 0.50 },
+	{ "latency, 90th percentile", "latency.p90", 0.90 },
+	{ "latency, 99th percentile", "latency.p99", 0.99 },
+	{ "latency, 99.9th percentile", "latency.p999", 0.999 },
+	{ "latency, 99.99th percentile", "latency.p9999", 0.9999 },
+    };
+
+    for(auto &[label, key, p]: percentiles) {
+	auto value = histogram.percentile(p);
+	rv.emplace_back( label, key, Measure<>(value / nano_to_milli, std::max(LatencyHistogram::resolution(value) / nano_to_milli, epsilon), "ms") );
+    }
+
+    return rv;
+}
+
+// cdf_tree(): the cumulative distribution of latency, from the histogram of all threads,
+// as an array of latency (ms, less the overhead to subtract) and percentile pairs, one per sub-bucket holding values
+static ptree cdf_tree(const LatencyHistogram &histogram, double overhead)
+{
+    ptree rv;
+
+    for(auto [value, seen]: histogram.cdf()) {
+	ptree point;
+	point.add("latency", d2s(std::max(value / nano_to_milli - overhead, 0.0)));
+	point.add("percentile", d2s(100.0 * seen / histogram.count()));
+	rv.push_back(std::make_pair("", point));
+    }
+
+    return rv;
+}
+
+// interval_t: what happened during an interval of a time series
+struct interval_t {
+    nanosecond_type start;	// since start, in ns
+    nanosecond_type length;	// in ns; the last interval may be shorter
+    size_t ops;			// number of calls completed successfully
+    size_t errors;		// number of calls failed, when errors are tolerated
+    double p50;			// latency percentiles of calls completed, in ms
+    double p99;
+    double concurrency;		// average number of threads inside a call
+
+    inline double tps() const { return length > 0 ? ops * 1e9 / length : 0.0; }
+};
+
+// time_series(): merge the intervals sampled by all threads while they ran (see IntervalSampler), and tell
+// for each interval how many calls completed, their latency, and how many threads were inside a call on average.
+// Latency percentiles come from the histogram of the interval, to 3 significant digits.
+static std::vector<interval_t> time_series(const std::vector<benchmark_result_t> &elapsed_time_array, nanosecond_type length)
+{
+    std::vector<interval_t> rv;
+    std::vector<interval_sample_t> merged;
+    nanosecond_type origin = std::numeric_limits<nanosecond_type>::max();
+    nanosecond_type end = 0;
+
+    // threads of a run share the origin of their intervals, see ActiveWindow
+    for(auto &elapsed: elapsed_time_array) {
+	auto &series = elapsed.series;
+	if(series.intervals.empty()) {
+	    continue;
+	}
+	origin = std::min(origin, series.origin);
+	end = std::max(end, series.end);
+	merged.resize(std::max(merged.size(), series.intervals.size()));
+	for(size_t i=0; i<series.intervals.size(); i++) {
+	    merged[i].merge(series.intervals[i]);
+	}
+    }
+
+    if(end <= origin || length == 0) {
+	return rv;
+    }
+
+    // a last interval shorter than half the length is merged with the previous one, not to give a skewed TPS
+    if(merged.size() > 1 && (end - origin) - static_cast<nanosecond_type>(merged.size() - 1) * length < length / 2) {
+	merged[merged.size() - 2].merge(merged.back());
+	merged.pop_back();
+    }
+
+    LatencyHistogram histogram;
+    for(size_t i=0; i<merged.size(); i++) {
+	auto start = static_cast<nanosecond_type>(i) * length;
+	interval_t interval { start, i + 1 < merged.size() ? length : end - origin - start, merged[i].ops, merged[i].errors, 0.0, 0.0, 0.0 };
+	histogram.from_sparse(merged[i].latency, merged[i].max);
+	interval.p50 = histogram.percentile(0.50) / nano_to_milli;
+	interval.p99 = histogram.percentile(0.99) / nano_to_milli;
+	interval.concurrency = static_cast<double>(merged[i].busy) / interval.length;
+	rv.push_back(interval);
+    }
+
+    return rv;
+}
+
+// sparkline(): values as a line of bars, from zero to the maximum. When there are more values than columns,
+// consecutive values are averaged.
+static std::string sparkline(const std::vector<double> &values, size_t columns)
+{
+    static const char *bars[] = { "\u2581", "\u2582", "\u2583", "\u2584", "\u2585", "\u2586", "\u2587", "\u2588" };
+    std::vector<double> averaged;
+    const size_t width = std::min(values.size(), columns);
+
+    for(size_t c=0; c<width; c++) {
+	auto first = values.begin() + c * values.size() / width;
+	auto last = values.begin() + (c + 1) * values.size() / width;
+	averaged.push_back(std::accumulate(first, last, 0.0) / (last - first));
+    }
+
+    std::string rv;
+    auto top = averaged.empty() ? 0.0 : *std::max_element(averaged.begin(), averaged.end());
+    for(auto value: averaged) {
+	rv += bars[top > 0.0 ? std::min<size_t>(static_cast<size_t>(value / top * 8), 7) : 0];
+    }
+
+    return rv;
+}
+
+// print_series(): display a time series on console, as sparklines
+static void print_series(const std::vector<interval_t> &series, std::chrono::nanoseconds length)
+{
+    if(series.empty()) {
+	return;
+    }
+
+    std::cout << "Time series (" << series.size() << " intervals of " << std::chrono::duration<double, std::milli>(length).count() << " ms):\n";
+
+    auto line = [&series] (const std::string &name, const std::string &unit, auto value) {
+		    std::vector<double> values;
+		    for(auto &interval: series) {
+			values.push_back(value(interval));
+		    }
+		    auto [low, high] = std::minmax_element(values.begin(), values.end());
+		    std::cout << "  " << std::left << std::setw(14) << name << sparkline(values, 60)
+			      << "  min " << d2s(*low, 6) << ", max " << d2s(*high, 6) << ' ' << unit << '\n';
+		};
+
+    line("TPS", "Tnx/s", [] (const interval_t &interval) { return interval.tps(); });
+    line("latency, p50", "ms", [] (const interval_t &interval) { return interval.p50; });
+    line("latency, p99", "ms", [] (const interval_t &interval) { return interval.p99; });
+    line("concurrency", "threads", [] (const interval_t &interval) { return interval.concurrency; });
+    if(std::any_of(series.begin(), series.end(), [] (const interval_t &interval) { return interval.errors > 0; })) {
+	line("errors", "calls", [] (const interval_t &interval) { return static_cast<double>(interval.errors); });
+    }
+    std::cout << std::endl;
+}
+
+// series_tree(): a time series, as JSON: the length of intervals (ms), and an array of intervals
+static ptree series_tree(const std::vector<interval_t> &series, std::chrono::nanoseconds length)
+{
+    ptree rv;
+    ptree points;
+
+    for(auto &interval: series) {
+	ptree point;
+	point.add("start", d2s(interval.start / nano_to_milli));
+	point.add("ops", i2s(interval.ops));
+	point.add("errors", i2s(interval.errors));
+	point.add("tps", d2s(interval.tps()));
+	point.add("latency.p50", d2s(interval.p50));
+	point.add("latency.p99", d2s(interval.p99));
+	point.add("concurrency", d2s(interval.concurrency));
+	points.push_back(std::make_pair("", point));
+    }
+
+    rv.add("interval", d2s(std::chrono::duration<double, std::milli>(length).count()));
+    rv.add_child("points", points);
+
+    return rv;
+}
+
+// timed(): tells if a result row is a time measured around calls, i.e. a latency or a service time, in any mode.
+// queueing delays, skews and wall clock are not.
+static bool timed(const std::string &key, Measure<> &measure)
+{
+    return measure.unit() == "ms"
+	&& (key.rfind("latency.", 0) == 0 || key.find(".latency.") != std::string::npos || key.rfind("service.", 0) == 0);
+}
+
+// subtract_overhead(): remove the mean harness overhead from times measured around calls.
+// the error on the mean overhead adds up to that of averages only: minimum, maximum and percentiles are taken
+// from single calls, whose own overhead varies as its spread tells (see overhead_facts())
+static void subtract_overhead(std::vector<result_row_t> &result_rows, const overhead_t &overhead)
+{
+    const std::string average { ".average" };
+
+    for(auto &[label, key, measure]: result_rows) {
+	if(timed(key, measure)) {
+	    auto averaged = key.size() > average.size() && key.compare(key.size() - average.size(), average.size(), average) == 0;
+	    measure = Measure<>(std::max(measure.value() - overhead.mean / nano_to_milli, 0.0),
+				measure.error() + (averaged ? overhead.error / nano_to_milli : 0.0), "ms");
+	}
+    }
+}
+
+// subtract_overhead(): same, for the latency percentiles of a time series. overhead is in ms
+static void subtract_overhead(std::vector<interval_t> &series, double overhead)
+{
+    for(auto &interval: series) {
+	interval.p50 = std::max(interval.p50 - overhead, 0.0);
+	interval.p99 = std::max(interval.p99 - overhead, 0.0);
+    }
+}
+
+// print_results(): display result rows on console
+static void print_results(std::vector<result_row_t> &result_rows)
+{
+    ConsoleTable results{"measure", "value", "error (+/-)", "unit", "rel. error" };
+    results.setStyle(1);
+
+    for(auto &row: result_rows) {
+	results += {
+	    std::get<0>(row),
+		d2s(std::get<2>(row).value(),12),
+		d2s(std::get<2>(row).error(),12),
+	    std::get<2>(row).unit(),
+	    d2s(std::get<2>(row).relerr()*100,3)+'%'  };
+    }
+
+    std::cout << "Test case results:\n" << results << std::endl;
+}
+
+// add_results(): add result rows to JSON output, under prefix
+static void add_results(ptree &rv, const std::string &prefix, std::vector<result_row_t> &result_rows)
+{
+    for(auto &row: result_rows) {
+	rv.add<double>(prefix + std::get<1>(row) + ".value",  std::get<2>(row).value());
+	rv.add(prefix + std::get<1>(row) + ".unit",   std::get<2>(row).unit());
+	rv.add(prefix + std::get<1>(row) + ".error",  d2s(std::get<2>(row).error()));
+	rv.add(prefix + std::get<1>(row) + ".relerr", d2s(std::get<2>(row).relerr()));
+    }
+}
+
+
+std::vector<fact_row_t> Executor::testcase_facts( P11Benchmark &benchmark, const std::string &testcase, const ExecutionPlan &plan )
+{
+    std::vector<fact_row_t> fact_rows {
+	{ "algorithm", "algorithm", benchmark.name() },
+	{ "vector size", "vector.size", i2s(m_vectors.at(testcase).size()) },
+	{ "vector unit", "vector.unit", "Byte" },
+	{ "key label", "label", benchmark.label() },
+	{ "number of threads", "threads", i2s(m_numthreads) },
+	{ "sessions/thread", "sessions", i2s(m_sessions_per_thread) },
+	{ "timer", "timer", CallTimer::clock() },
+    };
+
+    overhead_facts(fact_rows, plan);
+
+    if(processes() > 1) {
+	fact_rows.emplace_back( "number of processes", "processes", i2s(processes()) );
+    }
+
+    // with automatic skip, the number of skipped iterations is only known after execution, see warmup_facts()
+    auto skipped = plan.auto_skip() ? "auto, up to " + i2s(plan.autoskip) : i2s(plan.skipiterations);
+
+    if(plan.duration_based()) {
+	// the number of iterations is only known after execution, see iteration_facts()
+	fact_rows.emplace_back( "duration (s)", "duration", d2s(std::chrono::duration<double>(plan.duration).count()) );
+	fact_rows.emplace_back( "min. iterations/thread", "iterations.minimum", i2s(plan.miniterations) );
+	fact_rows.emplace_back( "skipped iterarions/thread", "iterations", skipped );
+    } else if(plan.adaptive()) {
+	// the number of iterations is only known after execution, see adaptive_run()
+	fact_rows.emplace_back( "max. iterations/thread", "iterations.maximum", i2s(plan.maxiterations) );
+	fact_rows.emplace_back( "iterations/thread, per chunk", "iterations", i2s(plan.iterations) );
+	fact_rows.emplace_back( "skipped iterarions/thread", "iterations", skipped );
+	fact_rows.emplace_back( "target relative error", "target.relerr", d2s(plan.target_relerr) );
+	fact_rows.emplace_back( "targeted measure", "target.measure",
+				plan.target_percentile > 0.0 ? "latency, " + d2s(plan.target_percentile * 100) + "th percentile" : "latency, average" );
+    } else {
+	fact_rows.emplace_back( "iterations/thread", "iterations", i2s(plan.iterations) );
+	fact_rows.emplace_back( "skipped iterarions/thread", "iterations", skipped );
+	fact_rows.emplace_back( "total of iterations", "total iterations", i2s(plan.iterations*m_numthreads*processes()) );
+    }
+
+    if(plan.open_loop()) {
+	fact_rows.emplace_back( "offered rate (Tnx/s)", "rate.offered", d2s(plan.rate) );
+	fact_rows.emplace_back( "offered rate/thread (Tnx/s)", "rate.thread", d2s(plan.rate/(m_numthreads*processes())) );
+    }
+
+    if(plan.router) {
+	std::string slots;
+	for(size_t s=0; s<plan.router->slots(); s++) {
+	    slots += (slots.empty() ? "" : ",") + i2s(plan.router->slot(s));
+	}
+	fact_rows.emplace_back( "slots", "slots", slots );
+	fact_rows.emplace_back( "routing policy", "routing", plan.router->policy() );
+    }
+
+    if(plan.thinktime.enabled()) {
+	fact_rows.emplace_back( "think time", "thinktime.model", plan.thinktime.to_string() );
+	fact_rows.emplace_back( "think time, mean (ms)", "thinktime.mean", d2s(plan.thinktime.mean().count() / nano_to_milli) );
+    }
+
+    if(plan.deadline.count() > 0) {
+	fact_rows.emplace_back( "deadline (ms)", "deadline.limit", d2s(plan.deadline.count() / nano_to_milli) );
+    }
+    if(plan.tolerate_errors) {
+	fact_rows.emplace_back( "errors tolerated", "errors.tolerated", "true" );
+    }
+    if(plan.retry.enabled()) {
+	fact_rows.emplace_back( "retry policy", "retries.policy", plan.retry.to_string() );
+    }
+
+    placement_facts(fact_rows);
+
+    return fact_rows;
+}
+
+
+// placement_facts(): when placement or scheduling was requested, add what was actually applied to each thread
+void Executor::placement_facts( std::vector<fact_row_t> &fact_rows )
+{
+    if(m_placement.enabled()) {
+	std::string applied;
+	for(size_t th=0; th<m_pool.size(); th++) {
+	    applied += (applied.empty() ? "" : "; ") + i2s(th) + ": " + m_pool.placement(th);
+	}
+
+	fact_rows.emplace_back( "placement", "placement.policy", m_placement.policy() );
+	fact_rows.emplace_back( "thread placement", "placement.threads", applied );
+    }
+}
+
+
+// overhead_facts(): once calibrated, the harness overhead with its spread, and whether it is subtracted from latency
+void Executor::overhead_facts( std::vector<fact_row_t> &fact_rows, const ExecutionPlan &plan )
+{
+    if(m_overhead) {
+	fact_rows.emplace_back( "harness overhead (ns)", "overhead.mean", d2s(m_overhead->mean, 4) );
+	fact_rows.emplace_back( "harness overhead, minimum (ns)", "overhead.minimum", d2s(m_overhead->minimum, 4) );
+	fact_rows.emplace_back( "harness overhead, median (ns)", "overhead.median", d2s(m_overhead->median, 4) );
+	fact_rows.emplace_back( "harness overhead, 99th percentile (ns)", "overhead.p99", d2s(m_overhead->p99, 4) );
+	fact_rows.emplace_back( "harness overhead, maximum (ns)", "overhead.maximum", d2s(m_overhead->maximum, 4) );
+	fact_rows.emplace_back( "harness overhead subtracted", "overhead.subtracted", plan.subtract_overhead ? "true" : "false" );
+    }
+}
+
+
+// overhead(): the harness overhead to subtract from latency, in ms. 0 unless calibrated, and the plan says so
+double Executor::overhead( const ExecutionPlan &plan ) const
+{
+    return plan.subtract_overhead && m_overhead ? m_overhead->mean / nano_to_milli : 0.0;
+}
+
+
+std::vector<ExecutionPlan> Executor::thread_plans( const ExecutionPlan &plan, size_t numthreads )
+{
+    std::vector<ExecutionPlan> rv(numthreads, plan);
+
+    for(auto &thread_plan: rv) {
+	thread_plan.window = &window();
+	thread_plan.overhead = std::chrono::nanoseconds(std::llround(overhead(plan) * nano_to_milli));
+    }
+
+    // sessions reopened by the retry policy are logged in to the token of this executor
+    if(plan.retry.enabled()) {
+	for(auto &thread_plan: rv) {
+	    thread_plan.password = m_password;
+	}
+    }
+
+    // in open loop, the offered rate is evenly spread accross threads (of all processes),
+    // and thread timelines are shifted, so that calls do not all happen at the same time.
+    if(plan.open_loop()) {
+	const size_t first = m_group ? m_group->rank() * numthreads : 0;
+	const size_t total = numthreads * processes();
+
+	for(size_t th=0; th<numthreads; th++) {
+	    rv[th].rate = plan.rate / total;
+	    rv[th].phase = static_cast<double>(first + th) / total;
+	}
+    }
+
+    return rv;
+}
+
+
+// dispatch(): submit one task per worker, start them together, and collect their results
+std::vector<benchmark_result_t> Executor::dispatch( std::vector<task_t> &tasks, nanosecond_type &wallclock_elapsed, RequestQueue *requests, bool restart )
+{
+    size_t th;
+    const size_t numthreads = tasks.size(); // one task per thread
+    std::vector<benchmark_result_t> elapsed_time_array(numthreads);
+    std::vector<std::future<benchmark_result_t> > future_array(numthreads);
+
+    boost::timer::cpu_timer wallclock_t;
+
+    // workers and this thread meet at the start line. With several processes, workers of all processes wait together
+    m_pool.startline().reset(numthreads+1, (numthreads+1) * processes());
+
+    // the active window starts afresh, with the origin of the previous run if this one continues it.
+    // With several processes, the leader resets it before the group syncs
+    if(!m_group || m_group->leader()) {
+	window().reset(numthreads * processes(), restart);
+    }
+
+    for(th=0; th<numthreads;th++) {
+	// worker th is bound to its own sessions
+	future_array[th] = m_pool.submit(th, std::move(tasks[th]));
+    }
+
+    // with several processes, all threads of all processes must be ready
+    if(m_group) {
+	m_pool.startline().await_others();
+	m_group->sync();
+    }
+
+    // wait until all threads are ready, then start the wall clock
+    auto start = m_pool.startline().arrive_and_wait();
+    wallclock_t.start();
+
+    // in pipelined mode, clients issue their first requests
+    if(requests) {
+	requests->open(start);
+    }
+
+    // wait for all workers before recovering futures,
+    // as a worker may throw while others still use shared objects.
+    // with a watchdog, a call stuck beyond the limit may never return: we give up, rather than hang
+    for(th=0;th<numthreads;th++) {
+	if(m_watchdog) {
+	    while(future_array[th].wait_for(m_watchdog->poll()) != std::future_status::ready) {
+		if(m_watchdog->stuck() > 0) {
+		    throw WatchdogException("calls stuck for more than the watchdog limit: " + m_watchdog->report());
+		}
+	    }
+	} else {
+	    future_array[th].wait();
+	}
+    }
+
+    // recover futures
+    for(th=0;th<numthreads;th++) {
+	elapsed_time_array[th] = future_array[th].get();
+    }
+
+    // stop wallclock and measure elapsed time
+    wallclock_t.stop();
+    wallclock_elapsed = wallclock_t.elapsed().wall;
+
+    // with several processes, results of all threads of all processes are taken into account
+    if(m_group) {
+	elapsed_time_array = m_group->allgather(elapsed_time_array, start, wallclock_elapsed);
+    }
+
+    return elapsed_time_array;
+}
+
+
+std::vector<benchmark_result_t> Executor::run( P11Benchmark &benchmark, const std::string &testcase, const std::vector<ExecutionPlan> &plans, nanosecond_type &wallclock_elapsed, RequestQueue *requests, bool restart )
+{
+    std::vector<task_t> tasks;
+    auto &payload = m_vectors.at(testcase);
+
+    // routing starts afresh for each run
+    if(!plans.empty() && plans.front().router) {
+	plans.front().router->reset();
+    }
+
+    for(auto &plan: plans) {
+	// make a copy of the benchmark object, for each thread.
+	// it is released by the worker, once the task is done.
+	std::shared_ptr<P11Benchmark> clone { benchmark.clone() };
+
+	if(requests) {
+	    tasks.emplace_back( [clone, &payload, plan, requests] (const std::vector<Session *> &sessions, std::optional<size_t> threadindex, Barrier &startline) {
+				    return clone->serve(sessions, payload, plan, threadindex, startline, *requests);
+				});
+	} else {
+	    tasks.emplace_back( [clone, &payload, plan] (const std::vector<Session *> &sessions, std::optional<size_t> threadindex, Barrier &startline) {
+				    return clone->execute(sessions, payload, plan, threadindex, startline);
+				});
+	}
+    }
+
+    return dispatch(tasks, wallclock_elapsed, requests, restart);
+}
+
+
+// adaptive_run(): run the benchmark in chunks of plan.iterations, until the relative error on the targeted measure
+// drops below plan.target_relerr, or plan.maxiterations are recorded per thread. Chunks are merged into a single result.
+std::vector<benchmark_result_t> Executor::adaptive_run( P11Benchmark &benchmark, const std::string &testcase, const ExecutionPlan &plan, nanosecond_type &wallclock_elapsed, std::vector<fact_row_t> &target_rows )
+{
+    std::vector<benchmark_result_t> rv;
+    auto plans = thread_plans(plan, m_numthreads);
+    auto epsilon = 2 * (m_timer_res + m_timer_res_err ) / nano_to_milli;
+    double relerr = std::numeric_limits<double>::infinity();
+    size_t chunks = 0;
+    bool failed = false;
+
+    wallclock_elapsed = 0;
+
+    while(true) {
+	nanosecond_type chunk_elapsed { 0 };
+	// chunks keep the active window origin of the first one: their time series intervals follow the wall clock,
+	// pauses between chunks included
+	auto chunk = run(benchmark, testcase, plans, chunk_elapsed, nullptr, chunks == 0);
+
+	// in closed loop, as in results(), statistics are computed over the window where all threads were active
+	merge_chunk(rv, chunk, wallclock_elapsed, !plan.open_loop() && chunk.size() > 1);
+	wallclock_elapsed += chunk_elapsed;
+	chunks++;
+
+	failed = std::any_of(rv.begin(), rv.end(), [] (auto &elapsed) { return elapsed.errcode != CKR_OK; });
+	if(failed) {
+	    break;		// something wrong happened, no need to carry on
+	}
+
+	// iterations are skipped in the first chunk only
+	for(auto &p: plans) {
+	    p.skipiterations = 0;
+	    p.autoskip = 0;
+	}
+
+	size_t least = std::numeric_limits<size_t>::max();
+	for(auto &elapsed: rv) {
+	    least = std::min(least, recorded(elapsed));
+	}
+
+	if(plan.histogram) {
+	    // iterations are summarized: the error is taken on those results() will keep
+	    auto summary = summarized(rv, windowed(rv, plan));
+	    if(plan.target_percentile > 0.0) {
+		relerr = percentile_relerr(summary.latency.histogram, plan.target_percentile);
+	    } else {
+		auto latency = average(summary.latency.moments, nano_to_milli, epsilon, "ms");
+		relerr = latency.value() > 0.0 ? latency.error() / latency.value() : std::numeric_limits<double>::infinity();
+	    }
+	} else {
+	    std::vector<double> samples;
+	    for(auto &elapsed: rv) {
+		for(auto record: elapsed.records) {
+		    samples.push_back(record/nano_to_milli);
+		}
+	    }
+
+	    if(plan.target_percentile > 0.0) {
+		relerr = percentile_relerr(samples, plan.target_percentile);
+	    } else {
+		auto latency = average(samples, epsilon, "ms");
+		relerr = latency.value() > 0.0 ? latency.error() / latency.value() : std::numeric_limits<double>::infinity();
+	    }
+	}
+
+	std::cout << "chunk " << chunks << ": " << least << " iterations/thread, relative error " << d2s(relerr,3) << std::endl;
+
+	if(relerr <= plan.target_relerr || least + plan.iterations > plan.maxiterations) {
+	    break;
+	}
+    }
+
+    target_rows.emplace_back( "chunks", "target.chunks", i2s(chunks) );
+    target_rows.emplace_back( "relative error achieved", "target.achieved", std::isinf(relerr) ? "n/a" : d2s(relerr) );
+    target_rows.emplace_back( "target reached", "target.reached", !failed && relerr <= plan.target_relerr ? "true" : "false" );
+
+    return rv;
+}
+
+
+std::vector<result_row_t> Executor::results( const std::vector<benchmark_result_t> &elapsed_time_array, nanosecond_type wallclock_elapsed, size_t vector_size, const ExecutionPlan &plan, int &last_errcode )
+{
+    std::vector<result_row_t> result_rows;
+    const size_t numthreads = elapsed_time_array.size();
+
+    // latency of calls taken into account, in ns. Moments are merged from summaries as well as accumulated from records
+    moments_t latency;
+
+    // helper map table for statistics, in ms
+    std::map<std::string, std::function<double()> > stats {
+	{ "min",   [&latency] () { return latency.min / nano_to_milli; }},
+	{ "mean",  [&latency] () { return latency.mean / nano_to_milli; }},
+	{ "max",   [&latency] () { return latency.max / nano_to_milli; }},
+	{ "range", [&latency] () { return (latency.max - latency.min) / nano_to_milli; }},
+	{ "svar",   [&latency] () { return latency.variance() / (nano_to_milli * nano_to_milli); }},
+	{ "sstddev", [&stats] () { return std::sqrt(stats["svar"]()); }},
+	// note: for error, we take k=2 so 95% of measures are within interval
+	{ "error", [&stats] () { return std::sqrt(stats["svar"]()/static_cast<double>( stats["count"]() ))*2; }},
+	{ "count", [&latency] () { return latency.count; }},
+    };
+
+    // in open loop, we keep samples to compute percentiles,
+    // and the achieved TPS is measured from the time spent by each thread
+    std::vector<double> samples;
+    double tps_achieved = 0.0;
+    double tps_achieved_relerr = 0.0;
+    double utilization = 0.0;
+
+    // with a deadline, the number of calls taken into account, and of those completed within the deadline
+    size_t deadline_total = 0;
+    size_t deadline_met = 0;
+
+    // in duration-based runs, threads may record a different number of iterations.
+    // in which case, we sum the TPS obtained by each thread, rather than extrapolating from one.
+    double tps_sum = 0.0;
+    double tps_sum_err2 = 0.0;
+
+    // epsilon represents the max resolution we have for a latency measurement.
+    // It sums the resolution and its standard error to it,
+    // ( = 2x stddev on sample mean, to reach 95% of interval)
+    // it is multiplied by two, as an interval is measured by making two time measurements. Therefore the
+    // uncertainties adds up.
+    // It is converted to milliseconds.
+    auto epsilon = 2 * (m_timer_res + m_timer_res_err ) / nano_to_milli;
+
+    last_errcode = CKR_OK;
+
+    // in closed loop, statistics are computed only over iterations executed while all threads were active, see windowed()
+    auto [window_start, window_end] = active_window(elapsed_time_array);
+    const bool windowed = ::windowed(elapsed_time_array, plan);
+
+    // in_window(): tells if iteration i of a thread is taken into account
+    auto in_window = [&windowed, window_start=window_start, window_end=window_end] (const benchmark_result_t &elapsed, size_t i) -> bool {
+			 return !windowed || (elapsed.timestamps[i] - elapsed.records[i] >= window_start && elapsed.timestamps[i] <= window_end);
+		     };
+
+    // error_in_window(): same, for failed call i of a thread
+    auto error_in_window = [&windowed, window_start=window_start, window_end=window_end] (const benchmark_result_t &elapsed, size_t i) -> bool {
+			       return !windowed || (elapsed.error_timestamps[i] - elapsed.errors[i] >= window_start && elapsed.error_timestamps[i] <= window_end);
+			   };
+
+    // when errors are tolerated, time spent by threads in successful and in failed calls
+    double succeeded_time = 0.0;
+    double failed_time = 0.0;
+
+    // paced and windowed: calls completed within the window, and time spent in calls within the window
+    size_t window_calls = 0;
+    double window_busy = 0.0;
+
+    // compute statistics
+    for(auto &elapsed: elapsed_time_array) {
+	if(elapsed.errcode != CKR_OK) {
+	    last_errcode = elapsed.errcode;
+	    wallclock_elapsed = 0;
+	    break;		// something wrong happened, no need to carry on
+	}
+
+	// with a histogram, iterations taken into account were summarized as the thread ran
+	moments_t thread = elapsed.in_window.latency.moments;
+	deadline_met += elapsed.in_window.deadline_met;
+	failed_time += elapsed.in_window.errors.sum;
+	if(!windowed) {
+	    thread += elapsed.outside.latency.moments;
+	    deadline_met += elapsed.outside.deadline_met;
+	    failed_time += elapsed.outside.errors.sum;
+	}
+
+	for(size_t i=0; i<elapsed.records.size(); i++) {
+	    if(in_window(elapsed, i)) {
+		thread.add(elapsed.records[i]);
+		deadline_met += elapsed.records[i] - overhead(plan) * nano_to_milli <= plan.deadline.count() ? 1 : 0;
+	    }
+	}
+
+	for(size_t i=0; i<elapsed.errors.size(); i++) {
+	    failed_time += error_in_window(elapsed, i) ? elapsed.errors[i] : 0;
+	}
+
+	latency += thread;
+	deadline_total += thread.count;
+	succeeded_time += thread.sum;
+
+	if(plan.duration_based() && !plan.paced() && thread.count > 1) {
+	    auto thread_mean = thread.mean / nano_to_milli;
+	    auto thread_err = std::max( std::sqrt(thread.variance() / thread.count) * 2 / nano_to_milli, epsilon );
+	    tps_sum += 1000 / thread_mean;
+	    tps_sum_err2 += std::pow( 1000 * thread_err / (thread_mean*thread_mean), 2 );
+	}
+
+	if(plan.paced()) {
+	    if(!plan.histogram) {
+		samples.reserve(samples.size() + thread.count);
+		for(size_t i=0; i<elapsed.records.size(); i++) {
+		    if(in_window(elapsed, i)) {
+			samples.push_back(elapsed.records[i]/nano_to_milli);
+		    }
+		}
+	    }
+	    if(windowed) {
+		// over the window, calls completed, and the time spent in calls, clipped to the window.
+		// summarized calls straddling the opening or the closing of the window are left out:
+		// there is at most one per thread at either end.
+		window_calls += elapsed.in_window.latency.moments.count;
+		window_busy += elapsed.in_window.latency.moments.sum;
+		for(size_t i=0; i<elapsed.records.size() && i<elapsed.timestamps.size(); i++) {
+		    auto end = elapsed.timestamps[i];
+		    auto begin = end - elapsed.records[i];
+		    window_calls += end >= window_start && end <= window_end ? 1 : 0;
+		    window_busy += std::max<nanosecond_type>(0, std::min(end, window_end) - std::max(begin, window_start));
+		}
+	    } else if(elapsed.span > 0) {
+		tps_achieved += 1e9 * thread.count / elapsed.span;
+		// the span is measured with two time measurements
+		tps_achieved_relerr = std::max(tps_achieved_relerr, 2 * (m_timer_res + m_timer_res_err) / elapsed.span);
+		// utilization: share of the span spent in calls, the rest being spent thinking
+		utilization += 100.0 * thread.sum / elapsed.span / numthreads;
+	    }
+	}
+    }
+
+    // with a histogram, the calls of all threads taken into account, summarized
+    const call_summary_t summary = plan.histogram ? summarized(elapsed_time_array, windowed) : call_summary_t {};
+
+    // with think time, latency is taken over the window: so are the achieved rate and utilization,
+    // measured over the window length rather than the span of each thread
+    if(plan.paced() && windowed) {
+	const double window = window_end - window_start;
+	tps_achieved = 1e9 * window_calls / window;
+	// the window is bounded by two time measurements
+	tps_achieved_relerr = 2 * (m_timer_res + m_timer_res_err) / window;
+	utilization = 100.0 * window_busy / window / numthreads;
+    }
+
+    // timer_res is the resolution of the timer
+    Measure<> timer_res(m_timer_res, m_timer_res_err, "ns");
+    result_rows.emplace_back(std::forward_as_tuple("timer resolution", "timer resolution", std::move(timer_res)));
+
+    // if the statistical error is less than epsilon, then it is no more significant,
+    // as the measure is blurred by the resolution of the timer.
+    // In which case, the error on latency is topped to epsilon
+    auto latency_avg_val = stats["mean"]();
+    auto latency_avg_err = stats["error"]() < epsilon ? epsilon : stats["error"]();
+    Measure<> latency_avg(latency_avg_val, latency_avg_err, "ms");
+    result_rows.emplace_back(std::forward_as_tuple("latency, average", "latency.average", std::move(latency_avg)));
+    // minimum and maximum are measured directly. their error depends directly upon
+    // the measurement of two times, i.e. t2-t1. Therefore, the error on that measurment
+    // equals twice the precision.
+    auto latency_min_val = stats["min"]();
+    auto latency_min_err = epsilon;
+    Measure<> latency_min(latency_min_val, latency_min_err, "ms");
+    result_rows.emplace_back(std::forward_as_tuple("latency, minimum", "latency.minimum", std::move(latency_min)));
+    auto latency_max_val = stats["max"]();;
+    auto latency_max_err =  epsilon;
+    Measure<> latency_max(latency_max_val, latency_max_err, "ms");
+    result_rows.emplace_back(std::forward_as_tuple("latency, maximum", "latency.maximum", std::move(latency_max)));
+
+    // global TPS, whatever the way it is obtained
+    double tps_total_val = 0.0;
+    double tps_total_err = 0.0;
+
+    std::vector<result_row_t> tail;
+    if(plan.histogram) {
+	tail = histogram_rows(summary.latency.histogram, epsilon);
+	result_rows.insert(result_rows.end(), tail.begin(), tail.end());
+    }
+
+    if(plan.paced()) {
+	// the percentile is a sample, measured directly, like min and max. With a histogram, it is already given
+	if(tail.empty()) {
+	    Measure<> latency_p99(percentile(samples, 0.99), epsilon, "ms");
+	    result_rows.emplace_back(std::forward_as_tuple("latency, 99th percentile", "latency.p99", std::move(latency_p99)));
+	}
+
+	// in open loop, latency includes the time spent waiting for the token to catch up.
+	// in open loop or with think time, threads are idle between calls: TPS cannot be inferred from latency.
+	// we report instead the rate that was actually achieved.
+	auto tps_global_val = tps_achieved;
+	auto tps_global_err = tps_achieved * tps_achieved_relerr;
+	tps_total_val = tps_global_val;
+	tps_total_err = tps_global_err;
+	Measure<> tps_thread(tps_global_val / numthreads, tps_global_err / numthreads, "Tnx/s");
+	result_rows.emplace_back(std::forward_as_tuple("TPS/thread, achieved", "tps.thread", std::move(tps_thread)));
+	Measure<> tps_global(tps_global_val, tps_global_err, "Tnx/s");
+	result_rows.emplace_back(std::forward_as_tuple("global TPS, achieved", "tps.global", std::move(tps_global)));
+
+	Measure<> throughput_thread(tps_global_val * vector_size / numthreads, tps_global_err * vector_size / numthreads, "Byte/s");
+	result_rows.emplace_back(std::forward_as_tuple("throughput/thread, achieved", "throughput.thread", std::move(throughput_thread)));
+	Measure<> throughput_global(tps_global_val * vector_size, tps_global_err * vector_size, "Byte/s");
+	result_rows.emplace_back(std::forward_as_tuple("global throughput, achieved", "throughput.global", std::move(throughput_global)));
+
+	if(plan.thinktime.enabled()) {
+	    // utilization tells how busy threads kept the token: latency is to be read against it
+	    Measure<> thread_utilization(utilization, utilization * tps_achieved_relerr, "%");
+	    result_rows.emplace_back(std::forward_as_tuple("thread utilization, average", "utilization", std::move(thread_utilization)));
+	}
+    } else {
+	// TPS is the number of "transactions" per second.
+	// the meaning of "transaction" depends upon the tested API/algorithm
+
+	// the statistics are computed over all threads. Therefore, the TPS it yields is per thread.
+	auto tps_thread_avg_val = 1000 / stats["mean"]();
+	auto tps_thread_avg_err = 1000 * latency_avg_err / (latency_avg_val*latency_avg_val) ;
+	// global TPS is simply obtained by multiplying TPS/thread by the number of threads
+	auto tps_global_avg_val = tps_thread_avg_val * numthreads;
+	auto tps_global_avg_err = tps_thread_avg_err * numthreads;
+
+	// unless threads have recorded a different number of iterations:
+	// global TPS is then the sum of TPS of each thread, and TPS/thread is their average.
+	// errors on each thread TPS are independent, they are added in quadrature.
+	if(plan.duration_based() && tps_sum > 0.0) {
+	    tps_global_avg_val = tps_sum;
+	    tps_global_avg_err = std::sqrt(tps_sum_err2);
+	    tps_thread_avg_val = tps_global_avg_val / numthreads;
+	    tps_thread_avg_err = tps_global_avg_err / numthreads;
+	}
+
+	// when errors are tolerated, threads also spend time in failed calls:
+	// only the share of time spent in successful calls yields transactions.
+	if(failed_time > 0.0) {
+	    auto busy = succeeded_time / (succeeded_time + failed_time);
+	    tps_thread_avg_val *= busy;
+	    tps_thread_avg_err *= busy;
+	    tps_global_avg_val *= busy;
+	    tps_global_avg_err *= busy;
+	}
+
+	tps_total_val = tps_global_avg_val;
+	tps_total_err = tps_global_avg_err;
+
+	Measure<> tps_thread_avg(tps_thread_avg_val, tps_thread_avg_err, "Tnx/s");
+	result_rows.emplace_back(std::forward_as_tuple("TPS/thread, average", "tps.thread", std::move(tps_thread_avg)));
+	Measure<> tps_global_avg(tps_global_avg_val, tps_global_avg_err, "Tnx/s");
+	result_rows.emplace_back(std::forward_as_tuple("global TPS, average", "tps.global", std::move(tps_global_avg)));
+	// throughput is obtained by multiplying TPS by vector size.
+	// Note that it is probably meaningful only to bulk encryption algorithms.
+	auto throughput_thread_avg_val = tps_thread_avg_val * vector_size;
+	auto throughput_thread_avg_err = tps_thread_avg_err * vector_size;
+	Measure<> throughput_thread_avg(throughput_thread_avg_val, throughput_thread_avg_err, "Byte/s");
+	result_rows.emplace_back(std::forward_as_tuple("throughput/thread, average", "throughput.thread", std::move(throughput_thread_avg)));
+
+	auto throughput_global_avg_val = throughput_thread_avg_val * numthreads;
+	auto throughput_global_avg_err = throughput_thread_avg_err * numthreads;
+	Measure<> throughput_global_avg(throughput_global_avg_val, throughput_global_avg_err, "Byte/s");
+	result_rows.emplace_back(std::forward_as_tuple("global throughput, average", "throughput.global", std::move(throughput_global_avg)));
+    }
+
+    if(plan.deadline.count() > 0 && last_errcode == CKR_OK) {
+	auto deadline = deadline_rows(deadline_met, deadline_total, tps_total_val, tps_total_err);
+	result_rows.insert(result_rows.end(), deadline.begin(), deadline.end());
+    }
+
+    if(plan.tolerate_errors && last_errcode == CKR_OK) {
+	auto errors = plan.histogram
+	    ? error_rows(summary, deadline_total, tps_total_val, tps_total_err, epsilon)
+	    : error_rows(elapsed_time_array, deadline_total, tps_total_val, tps_total_err, epsilon, error_in_window);
+	result_rows.insert(result_rows.end(), errors.begin(), errors.end());
+    }
+
+    if(plan.retry.enabled() && last_errcode == CKR_OK) {
+	auto retry = plan.histogram
+	    ? retry_rows(elapsed_time_array, summary, epsilon)
+	    : retry_rows(elapsed_time_array, epsilon, in_window);
+	result_rows.insert(result_rows.end(), retry.begin(), retry.end());
+    }
+
+    if(plan.cpu_usage && last_errcode == CKR_OK) {
+	auto cpu = cpu_rows(elapsed_time_array);
+	result_rows.insert(result_rows.end(), cpu.begin(), cpu.end());
+    }
+
+    if(plan.router && last_errcode == CKR_OK) {
+	auto slots = plan.histogram
+	    ? slot_rows(summary, *plan.router, tps_total_val, tps_total_err, epsilon)
+	    : slot_rows(elapsed_time_array, *plan.router, tps_total_val, tps_total_err, epsilon, in_window);
+	result_rows.insert(result_rows.end(), slots.begin(), slots.end());
+    }
+
+    // in adaptive runs, threads start and finish once per chunk: skews are not reported
+    if(numthreads > 1 && !plan.adaptive() && last_errcode == CKR_OK) {
+	auto skew = skew_rows(elapsed_time_array, epsilon);
+	result_rows.insert(result_rows.end(), skew.begin(), skew.end());
+    }
+
+    // wallclock_elapsed_ms is the total time elapsed (in ms).
+    Measure<> wallclock_elapsed_ms( wallclock_elapsed/nano_to_milli, epsilon, "ms" );
+    result_rows.emplace_back(std::forward_as_tuple("wall clock", "wallclock", std::move(wallclock_elapsed_ms)));
+
+
+    if(plan.subtract_overhead && m_overhead) {
+	subtract_overhead(result_rows, *m_overhead);
+    }
+
+    return result_rows;
+}
+
+
+overhead_t Executor::calibrate( size_t iterations )
+{
+    P11NoopBenchmark noop;
+    ExecutionPlan plan {};
+    nanosecond_type wallclock_elapsed { 0 };
+
+    // the first iterations warm up caches and branch predictors
+    plan.iterations = iterations;
+    plan.skipiterations = iterations / 10;
+    plan.traced = false;	// empty calls are not part of the run
+
+    // any vector will do, it is not used
+    auto elapsed_time_array = run(noop, m_vectors.begin()->first, thread_plans(plan, m_numthreads), wallclock_elapsed);
+
+    std::vector<double> samples;
+    for(auto &elapsed: elapsed_time_array) {
+	samples.insert(samples.end(), elapsed.records.begin(), elapsed.records.end());
+    }
+
+    overhead_t rv {};
+    if(samples.empty()) {
+	return rv;
+    }
+
+    bacc::accumulator_set< double, bacc::stats< bacc::tag::mean, bacc::tag::variance, bacc::tag::min, bacc::tag::max > > acc;
+    for(auto sample: samples) {
+	acc(sample);
+    }
+
+    auto n = samples.size();
+    rv.mean = bacc::mean(acc);
+    rv.error = n > 1 ? std::sqrt(bacc::variance(acc) / (n - 1)) * 2 : 0.0;
+    rv.minimum = bacc::min(acc);
+    rv.maximum = bacc::max(acc);
+    rv.median = percentile(samples, 0.50);
+    rv.p99 = percentile(samples, 0.99);
+
+    m_overhead = rv;
+    return rv;
+}
+
+
+ptree Executor::benchmark( P11Benchmark &benchmark, const ExecutionPlan &plan, const std::forward_list<std::string> shortlist )
+{
+
+    ptree rv;
+
+    for(auto testcase: shortlist) {
+	int last_errcode = CKR_OK;
+	nanosecond_type wallclock_elapsed { 0 }; // used to measure how much time in total was spent in executing the test
+
+	auto fact_rows = testcase_facts(benchmark, testcase, plan);
+
+	print_facts(benchmark, fact_rows);
+
+	std::vector<fact_row_t> target_rows;
+	auto elapsed_time_array = plan.adaptive()
+	    ? adaptive_run(benchmark, testcase, plan, wallclock_elapsed, target_rows)
+	    : run(benchmark, testcase, thread_plans(plan, m_numthreads), wallclock_elapsed);
+	auto result_rows = results(elapsed_time_array, wallclock_elapsed, m_vectors.at(testcase).size(), plan, last_errcode);
+
+	std::vector<fact_row_t> iteration_rows;
+
+	if(plan.duration_based() || plan.adaptive()) {
+	    iteration_rows = iteration_facts(elapsed_time_array);
+	    iteration_rows.insert(iteration_rows.end(), target_rows.begin(), target_rows.end());
+	}
+
+	if(plan.auto_skip()) {
+	    auto warmup_rows = warmup_facts(elapsed_time_array);
+	    iteration_rows.insert(iteration_rows.end(), warmup_rows.begin(), warmup_rows.end());
+	}
+
+	if(!iteration_rows.empty()) {
+	    print_iterations(iteration_rows);
+	    fact_rows.insert(fact_rows.end(), iteration_rows.begin(), iteration_rows.end());
+	}
+
+	print_results(result_rows);
+
+	auto series = time_series(elapsed_time_array, plan.sample_interval.count());
+	subtract_overhead(series, overhead(plan));
+	print_series(series, plan.sample_interval);
+
+	// now create json output
+	std::string thistestcase { benchmark.label() + '.' + testcase + '.' };
+
+	// adding facts information
+	for(auto &row: fact_rows) {
+	    rv.add(thistestcase + std::get<1>(row), std::get<2>(row) );
+	}
+
+	// adding results information
+	add_results(rv, thistestcase, result_rows);
+
+	if(!series.empty()) {
+	    rv.add_child(thistestcase + "timeseries", series_tree(series, plan.sample_interval));
+	}
+
+	// with a histogram, the whole latency distribution is given
+	if(plan.histogram && last_errcode == CKR_OK) {
+	    // over the same iterations as other statistics, see results()
+	    auto summary = summarized(elapsed_time_array, windowed(elapsed_time_array, plan));
+	    rv.add_child(thistestcase + "latency.cdf", cdf_tree(summary.latency.histogram, overhead(plan)));
+	}
+
+	// last error code, useful to identify when something crashes
+	rv.add(thistestcase + "errorcode", errorcode(last_errcode));
+    }
+
+    return rv;
+}
+
+
+ptree Executor::rate_sweep( P11Benchmark &benchmark, const ExecutionPlan &plan, RateCoverage &rates, const std::forward_list<std::string> shortlist )
+{
+    ptree rv;
+
+    for(auto testcase: shortlist) {
+	int last_errcode = CKR_OK;
+
+	auto fact_rows = testcase_facts(benchmark, testcase, plan);
+
+	std::string offered_rates;
+	for(auto rate: rates) {
+	    offered_rates += (offered_rates.empty() ? "" : ",") + d2s(rate);
+	}
+	fact_rows.emplace_back( "offered rates (Tnx/s)", "rate.sweep", offered_rates );
+
+	print_facts(benchmark, fact_rows);
+
+	ConsoleTable curve { "offered load (Tnx/s)", "achieved TPS (Tnx/s)", "latency, average (ms)", "latency, p99 (ms)", "error code" };
+	curve.setStyle(1);
+
+	ptree points;
+
+	for(auto rate: rates) {
+	    nanosecond_type wallclock_elapsed { 0 };
+	    int point_errcode = CKR_OK;
+	    ExecutionPlan point_plan { plan };
+	    point_plan.rate = rate;
+
+	    std::cout << "offered load: " << rate << " Tnx/s..." << std::endl;
+
+	    auto elapsed_time_array = run(benchmark, testcase, thread_plans(point_plan, m_numthreads), wallclock_elapsed);
+	    auto result_rows = results(elapsed_time_array, wallclock_elapsed, m_vectors.at(testcase).size(), point_plan, point_errcode);
+
+	    auto measure_of = [&result_rows] (const std::string &name) -> Measure<> & {
+				  return std::get<2>(*std::find_if(result_rows.begin(), result_rows.end(),
+								   [&name] (auto &row) { return std::get<1>(row) == name; }));
+			      };
+
+	    curve += { d2s(rate),
+		       d2s(measure_of("tps.global").value(),12),
+		       d2s(measure_of("latency.average").value(),12),
+		       d2s(measure_of("latency.p99").value(),12),
+		       errorcode(point_errcode) };
+
+	    ptree point;
+	    point.add("offered", d2s(rate));
+	    if(plan.duration_based()) {
+		for(auto &row: iteration_facts(elapsed_time_array)) {
+		    point.add(std::get<1>(row), std::get<2>(row));
+		}
+	    }
+	    add_results(point, "", result_rows);
+	    point.add("errorcode", errorcode(point_errcode));
+	    points.push_back(std::make_pair("", point));
+
+	    if(point_errcode != CKR_OK) {
+		last_errcode = point_errcode;
+		break;		// the token gave up, no need to increase the load
+	    }
+	}
+
+	std::cout << "Load curve:\n" << curve << std::endl;
+
+	// now create json output
+	std::string thistestcase { benchmark.label() + '.' + testcase + '.' };
+
+	// adding facts information
+	for(auto &row: fact_rows) {
+	    rv.add(thistestcase + std::get<1>(row), std::get<2>(row) );
+	}
+
+	rv.add_child(thistestcase + "ratesweep", points);
+
+	// last error code, useful to identify when something crashes
+	rv.add(thistestcase + "errorcode", errorcode(last_errcode));
+    }
+
+    return rv;
+}
+
+
+ptree Executor::ramp( P11Benchmark &benchmark, const ExecutionPlan &plan, const RampProfile &profile, const std::forward_list<std::string> shortlist )
+{
+    ptree rv;
+    const auto steps = profile.steps();
+    const auto interval = profile.interval();
+
+    for(auto testcase: shortlist) {
+	int last_errcode = CKR_OK;
+	nanosecond_type wallclock_elapsed { 0 };
+
+	// all threads run until the end of the ramp, in closed loop,
+	// but each of them joins at the step where it becomes active.
+	ExecutionPlan ramp_plan { plan };
+	ramp_plan.rate = 0.0;
+	ramp_plan.duration = profile.duration();
+
+	auto plans = thread_plans(ramp_plan, profile.maxthreads());
+	for(size_t step=0, th=0; step<steps.size(); step++) {
+	    for(; th<steps[step]; th++) {
+		plans[th].start_offset = interval * step;
+	    }
+	}
+
+	auto fact_rows = testcase_facts(benchmark, testcase, ramp_plan);
+
+	std::string active_threads;
+	for(auto active: steps) {
+	    active_threads += (active_threads.empty() ? "" : ",") + i2s(active);
+	}
+	fact_rows.emplace_back( "active threads per step", "ramp.threads", active_threads );
+	fact_rows.emplace_back( "step duration (s)", "ramp.interval", d2s(std::chrono::duration<double>(interval).count()) );
 
-namespace bacc = boost::accumulators;
-constexpr double nano_to_milli = 1000000.0 ;
+	print_facts(benchmark, fact_rows);
+
+	auto elapsed_time_array = run(benchmark, testcase, plans, wallclock_elapsed);
+
+	// dispatch latencies into steps, according to the completion time of each iteration.
+	// iterations completed after the end of the ramp (because of --min-iterations) are left aside.
+	std::vector<std::vector<double>> step_samples(steps.size());
+
+	for(auto &elapsed: elapsed_time_array) {
+	    if(elapsed.errcode != CKR_OK) {
+		last_errcode = elapsed.errcode;
+	    }
+
+	    for(size_t i=0; i<elapsed.records.size(); i++) {
+		auto step = static_cast<size_t>(elapsed.timestamps[i] / interval.count());
+		if(step < steps.size()) {
+		    step_samples[step].push_back(elapsed.records[i]/nano_to_milli);
+		}
+	    }
+	}
+
+	ConsoleTable table { "step", "active threads", "iterations", "TPS (Tnx/s)", "latency, average (ms)",
+			     "latency, p50 (ms)", "latency, p90 (ms)", "latency, p99 (ms)", "latency, maximum (ms)" };
+	table.setStyle(1);
+
+	ptree points;
+
+	for(size_t step=0; step<steps.size(); step++) {
+	    auto &samples = step_samples[step];
+	    double sum = 0.0;
+
+	    for(auto sample: samples) {
+		sum += sample;
+	    }
+
+	    auto tps = samples.size() / std::chrono::duration<double>(interval).count();
+	    auto average = samples.empty() ? 0.0 : sum / samples.size();
+	    auto p50 = percentile(samples, 0.50);
+	    auto p90 = percentile(samples, 0.90);
+	    auto p99 = percentile(samples, 0.99);
+	    auto maximum = percentile(samples, 1.0);
+
+	    // see subtract_overhead()
+	    if(!samples.empty()) {
+		for(auto figure: { &average, &p50, &p90, &p99, &maximum }) {
+		    *figure = std::max(*figure - overhead(plan), 0.0);
+		}
+	    }
+
+	    table += { i2s(step+1), i2s(steps[step]), i2s(samples.size()), d2s(tps,6),
+		       d2s(average,6), d2s(p50,6), d2s(p90,6), d2s(p99,6), d2s(maximum,6) };
+
+	    ptree point;
+	    point.add("step", step+1);
+	    point.add("threads", steps[step]);
+	    point.add("start", d2s(std::chrono::duration<double>(interval * step).count()));
+	    point.add("iterations", samples.size());
+	    point.add("tps", d2s(tps));
+	    point.add("latency.unit", "ms");
+	    point.add("latency.average", d2s(average));
+	    point.add("latency.p50", d2s(p50));
+	    point.add("latency.p90", d2s(p90));
+	    point.add("latency.p99", d2s(p99));
+	    point.add("latency.maximum", d2s(maximum));
+	    points.push_back(std::make_pair("", point));
+	}
+
+	std::cout << "Ramp results:\n" << table << std::endl;
+
+	// now create json output
+	std::string thistestcase { benchmark.label() + '.' + testcase + '.' };
+
+	// adding facts information
+	for(auto &row: fact_rows) {
+	    rv.add(thistestcase + std::get<1>(row), std::get<2>(row) );
+	}
+
+	rv.add_child(thistestcase + "ramp", points);
+
+	// last error code, useful to identify when something crashes
+	rv.add(thistestcase + "errorcode", errorcode(last_errcode));
+    }
+
+    return rv;
+}
+
+
+ptree Executor::threads_sweep( P11Benchmark &benchmark, const ExecutionPlan &plan, ThreadCoverage &levels, const std::forward_list<std::string> shortlist )
+{
+    ptree rv;
+
+    for(auto testcase: shortlist) {
+	int last_errcode = CKR_OK;
+
+	auto fact_rows = testcase_facts(benchmark, testcase, plan);
+
+	std::string thread_counts;
+	for(auto level: levels) {
+	    thread_counts += (thread_counts.empty() ? "" : ",") + i2s(level);
+	}
+	fact_rows.emplace_back( "thread counts", "sweep.threads", thread_counts );
+
+	print_facts(benchmark, fact_rows);
+
+	// the same sessions (and session keys) are reused at every level: level n uses the first n sessions.
+	std::vector<std::pair<double, double>> measures;
+	std::vector<std::tuple<size_t, Measure<>, Measure<>, int>> rows;
+	ptree points;
+
+	for(auto level: levels) {
+	    nanosecond_type wallclock_elapsed { 0 };
+	    int point_errcode = CKR_OK;
+
+	    std::cout << "threads: " << level << "..." << std::endl;
+
+	    auto elapsed_time_array = run(benchmark, testcase, thread_plans(plan, level), wallclock_elapsed);
+	    auto result_rows = results(elapsed_time_array, wallclock_elapsed, m_vectors.at(testcase).size(), plan, point_errcode);
+
+	    auto measure_of = [&result_rows] (const std::string &name) -> Measure<> & {
+				  return std::get<2>(*std::find_if(result_rows.begin(), result_rows.end(),
+								   [&name] (auto &row) { return std::get<1>(row) == name; }));
+			      };
+
+	    rows.emplace_back(level, measure_of("tps.global"), measure_of("latency.average"), point_errcode);
+
+	    ptree point;
+	    point.add("threads", level);
+	    if(plan.duration_based()) {
+		for(auto &row: iteration_facts(elapsed_time_array)) {
+		    point.add(std::get<1>(row), std::get<2>(row));
+		}
+	    }
+	    add_results(point, "", result_rows);
+	    point.add("errorcode", errorcode(point_errcode));
+	    points.push_back(std::make_pair("", point));
+
+	    if(point_errcode != CKR_OK) {
+		last_errcode = point_errcode;
+		break;		// the token gave up, no need to add more threads
+	    }
+
+	    measures.emplace_back(level, measure_of("tps.global").value());
+	}
+
+	auto fit = fit_usl(measures);
+
+	ConsoleTable curve { "threads", "global TPS (Tnx/s)", "error (+/-)", "latency, average (ms)", "USL model (Tnx/s)", "error code" };
+	curve.setStyle(1);
+
+	for(auto &row: rows) {
+	    curve += { i2s(std::get<0>(row)),
+		       d2s(std::get<1>(row).value(),12),
+		       d2s(std::get<1>(row).error(),12),
+		       d2s(std::get<2>(row).value(),12),
+		       fit.valid ? d2s(fit.throughput(std::get<0>(row)),12) : "n/a",
+		       errorcode(std::get<3>(row)) };
+	}
+
+	std::cout << "Scalability curve:\n" << curve << std::endl;
+
+	ptree scalability;
+
+	if(!measures.empty()) {
+	    // saturation: the level at which the highest throughput was observed
+	    auto saturation = *std::max_element(measures.begin(), measures.end(),
+						[] (auto &a, auto &b) { return a.second < b.second; });
+
+	    // M/M/c estimate: if the token had c engines, each serving at the rate observed with a single client,
+	    // then its capacity would be c times that rate. Any client or network overhead inflates the estimate,
+	    // which is therefore an upper bound.
+	    auto single = fit.valid ? fit.lambda : measures.front().second / measures.front().first;
+	    auto engines = single > 0.0 ? saturation.second / single : 0.0;
+
+	    ConsoleTable summary { "property", "value" };
+	    summary.setStyle(1);
+
+	    summary += { "highest TPS observed (Tnx/s)", d2s(saturation.second,12) };
+	    summary += { "reached with threads", d2s(saturation.first) };
+	    summary += { "estimated crypto engines", d2s(engines,3) };
+
+	    scalability.add("observed.tps", d2s(saturation.second));
+	    scalability.add("observed.threads", d2s(saturation.first));
+	    scalability.add("engines", d2s(engines));
+
+	    if(fit.valid) {
+		auto peak = fit.peak_concurrency();
+
+		summary += { "USL, single thread TPS (lambda)", d2s(fit.lambda,12) };
+		summary += { "USL, contention (sigma)", d2s(fit.sigma,6) };
+		summary += { "USL, coherency (kappa)", d2s(fit.kappa,6) };
+		summary += { "USL, coefficient of determination (R2)", d2s(fit.r2,6) };
+		summary += { "USL, peak concurrency (threads)", std::isinf(peak) ? "unbounded" : d2s(peak,4) };
+		summary += { "USL, peak TPS (Tnx/s)", d2s(fit.peak_throughput(),12) };
+
+		scalability.add("usl.lambda", d2s(fit.lambda));
+		scalability.add("usl.sigma", d2s(fit.sigma));
+		scalability.add("usl.kappa", d2s(fit.kappa));
+		scalability.add("usl.r2", d2s(fit.r2));
+		scalability.add("usl.peak.threads", std::isinf(peak) ? "unbounded" : d2s(peak));
+		scalability.add("usl.peak.tps", d2s(fit.peak_throughput()));
+	    } else {
+		summary += { "USL fit", "n/a (at least 3 thread counts are needed)" };
+	    }
+
+	    std::cout << "Scalability summary:\n" << summary << std::endl;
+	}
+
+	// now create json output
+	std::string thistestcase { benchmark.label() + '.' + testcase + '.' };
+
+	// adding facts information
+	for(auto &row: fact_rows) {
+	    rv.add(thistestcase + std::get<1>(row), std::get<2>(row) );
+	}
+
+	rv.add_child(thistestcase + "threadsweep", points);
+	rv.add_child(thistestcase + "scalability", scalability);
 
+	// last error code, useful to identify when something crashes
+	rv.add(thistestcase + "errorcode", errorcode(last_errcode));
+    }
+
+    return rv;
+}
 
-ptree Executor::benchmark( P11Benchmark &benchmark, const size_t iter, const size_t skipiter, const std::forward_list<std::string> shortlist )
+
+std::vector<result_row_t> Executor::pipeline_results( const std::vector<benchmark_result_t> &elapsed_time_array, nanosecond_type wallclock_elapsed, size_t vector_size, const ExecutionPlan &plan, int &last_errcode )
 {
+    std::vector<result_row_t> result_rows;
+    std::vector<double> response, service, queueing;
+    double busy = 0.0;		// total time spent by carriers serving requests, in ms
+
+    // see results() for how epsilon is obtained
+    auto epsilon = 2 * (m_timer_res + m_timer_res_err ) / nano_to_milli;
 
+    last_errcode = CKR_OK;
+
+    for(auto &elapsed: elapsed_time_array) {
+	if(elapsed.errcode != CKR_OK) {
+	    last_errcode = elapsed.errcode;
+	}
+
+	for(size_t i=0; i<elapsed.records.size(); i++) {
+	    service.push_back(elapsed.records[i]/nano_to_milli);
+	    queueing.push_back(elapsed.queueing[i]/nano_to_milli);
+	    // the response time, as seen by the client, includes queueing delay
+	    response.push_back(service.back() + queueing.back());
+	    busy += service.back();
+	}
+    }
+
+    Measure<> timer_res(m_timer_res, m_timer_res_err, "ns");
+    result_rows.emplace_back(std::forward_as_tuple("timer resolution", "timer resolution", std::move(timer_res)));
+
+    // for each kind of time, we report average, 99th percentile and maximum.
+    // percentiles and maximum are measured directly, their error is epsilon.
+    auto add_times = [&result_rows, &epsilon] (const std::string &label, const std::string &key, std::vector<double> &samples) {
+			 result_rows.emplace_back(std::forward_as_tuple(label + ", average", key + ".average", average(samples, epsilon, "ms")));
+			 result_rows.emplace_back(std::forward_as_tuple(label + ", 99th percentile", key + ".p99", Measure<>(percentile(samples, 0.99), epsilon, "ms")));
+			 result_rows.emplace_back(std::forward_as_tuple(label + ", maximum", key + ".maximum", Measure<>(percentile(samples, 1.0), epsilon, "ms")));
+		     };
+
+    add_times("latency", "latency", response);
+    add_times("service time", "service", service);
+    add_times("queueing delay", "queueing", queueing);
+
+    // TPS is obtained from the number of requests completed during the wall clock time.
+    // the wall clock is measured with two time measurements, hence its error.
+    auto wallclock_ms = wallclock_elapsed / nano_to_milli;
+    auto tps_global_val = wallclock_ms > 0.0 ? 1000 * service.size() / wallclock_ms : 0.0;
+    auto tps_global_err = wallclock_ms > 0.0 ? tps_global_val * epsilon / wallclock_ms : 0.0;
+    auto clients = m_requests.clients();
+
+    Measure<> tps_client(tps_global_val / clients, tps_global_err / clients, "Tnx/s");
+    result_rows.emplace_back(std::forward_as_tuple("TPS/client, achieved", "tps.client", std::move(tps_client)));
+    Measure<> tps_global(tps_global_val, tps_global_err, "Tnx/s");
+    result_rows.emplace_back(std::forward_as_tuple("global TPS, achieved", "tps.global", std::move(tps_global)));
+    Measure<> throughput_global(tps_global_val * vector_size, tps_global_err * vector_size, "Byte/s");
+    result_rows.emplace_back(std::forward_as_tuple("global throughput, achieved", "throughput.global", std::move(throughput_global)));
+
+    // utilization of carriers: the fraction of time they spend serving requests.
+    // when it reaches 100%, carriers are saturated and queueing delay grows with the number of requests in flight.
+    auto utilization_val = wallclock_ms > 0.0 ? 100 * busy / (wallclock_ms * elapsed_time_array.size()) : 0.0;
+    auto utilization_err = wallclock_ms > 0.0 ? utilization_val * epsilon / wallclock_ms : 0.0;
+    Measure<> utilization(utilization_val, utilization_err, "%");
+    result_rows.emplace_back(std::forward_as_tuple("carrier utilization", "utilization", std::move(utilization)));
+
+    // the deadline applies to the latency seen by clients, queueing delay included
+    if(plan.deadline.count() > 0) {
+	// with --subtract-overhead, latency is compared to the deadline less the overhead, as it is reported
+	auto deadline_ms = plan.deadline.count() / nano_to_milli;
+	auto met = std::count_if(response.begin(), response.end(), [deadline_ms, overhead=overhead(plan)] (double latency) { return latency - overhead <= deadline_ms; });
+	auto deadline = deadline_rows(met, response.size(), tps_global_val, tps_global_err);
+	result_rows.insert(result_rows.end(), deadline.begin(), deadline.end());
+    }
+
+    // the latency of a slot is its service time
+    if(plan.router) {
+	auto slots = slot_rows(elapsed_time_array, *plan.router, tps_global_val, tps_global_err, epsilon,
+			       [] (const benchmark_result_t &, size_t) { return true; });
+	result_rows.insert(result_rows.end(), slots.begin(), slots.end());
+    }
+
+    Measure<> wallclock_elapsed_ms( wallclock_ms, epsilon, "ms" );
+    result_rows.emplace_back(std::forward_as_tuple("wall clock", "wallclock", std::move(wallclock_elapsed_ms)));
+
+
+    if(plan.subtract_overhead && m_overhead) {
+	subtract_overhead(result_rows, *m_overhead);
+    }
+
+    return result_rows;
+}
+
+
+ptree Executor::pipeline( P11Benchmark &benchmark, const ExecutionPlan &plan, size_t clients, size_t inflight, const std::forward_list<std::string> shortlist )
+{
     ptree rv;
 
     for(auto testcase: shortlist) {
-	size_t th;
-	std::vector<benchmark_result_t> elapsed_time_array(m_numthreads);
-	std::vector<std::future<benchmark_result_t> > future_array(m_numthreads);
-	std::vector<P11Benchmark *> benchmark_array(m_numthreads);
 	int last_errcode = CKR_OK;
+	nanosecond_type wallclock_elapsed { 0 };
 
-	boost::timer::cpu_timer wallclock_t;
-	nanosecond_type wallclock_elapsed { 0 }; // used to measure how much time in total was spent in executing the test
+	auto fact_rows = testcase_facts(benchmark, testcase, plan);
+
+	// the number of iterations is given per client, not per thread
+	for(auto &row: fact_rows) {
+	    if(std::get<0>(row) == "iterations/thread") {
+		std::get<0>(row) = "iterations/client";
+	    } else if(std::get<1>(row) == "total iterations") {
+		std::get<2>(row) = i2s(plan.iterations*clients);
+	    }
+	}
+
+	fact_rows.emplace_back( "logical clients", "clients", i2s(clients) );
+	fact_rows.emplace_back( "requests in flight/client", "inflight", i2s(inflight) );
+
+	print_facts(benchmark, fact_rows);
+
+	// carriers serve requests until none is left
+	m_requests.reset(clients, inflight, plan.iterations, plan.duration);
 
-	// helper functions for ConsoleTable conversion of items to string
-	auto d2s = [] (double arg, int precision=-1) -> std::string {
-		       std::ostringstream stream;
-		       if(precision>=0) stream << std::setprecision(precision);
-		       stream << arg;
-		       return stream.str();
-		   };
-
-	auto i2s = [] (long arg) -> std::string {
-		       std::ostringstream stream;
-		       stream << arg;
-		       return stream.str();
-		   };
-
-	std::vector<std::tuple<std::string, std::string, std::string>> fact_rows {
-	    { "algorithm", "algorithm", benchmark.name() },
-	    { "vector size", "vector.size", i2s(m_vectors.at(testcase).size()) },
+	auto elapsed_time_array = run(benchmark, testcase, thread_plans(plan, m_numthreads), wallclock_elapsed, &m_requests);
+	auto result_rows = pipeline_results(elapsed_time_array, wallclock_elapsed, m_vectors.at(testcase).size(), plan, last_errcode);
+
+	// report how requests were spread accross threads.
+	// the total is already known from facts.
+	std::vector<fact_row_t> request_rows;
+	for(auto &row: iteration_facts(elapsed_time_array)) {
+	    if(std::get<1>(row) == "iterations.thread.minimum") {
+		request_rows.emplace_back( "requests served/thread, minimum", "requests.thread.minimum", std::get<2>(row) );
+	    } else if(std::get<1>(row) == "iterations.thread.maximum") {
+		request_rows.emplace_back( "requests served/thread, maximum", "requests.thread.maximum", std::get<2>(row) );
+	    }
+	}
+	print_iterations(request_rows);
+	fact_rows.insert(fact_rows.end(), request_rows.begin(), request_rows.end());
+
+	print_results(result_rows);
+
+	// service time is sampled: concurrency is the number of carriers busy with the token
+	auto series = time_series(elapsed_time_array, plan.sample_interval.count());
+	subtract_overhead(series, overhead(plan));
+	print_series(series, plan.sample_interval);
+
+	// now create json output
+	std::string thistestcase { benchmark.label() + '.' + testcase + '.' };
+
+	// adding facts information
+	for(auto &row: fact_rows) {
+	    rv.add(thistestcase + std::get<1>(row), std::get<2>(row) );
+	}
+
+	// adding results information
+	add_results(rv, thistestcase, result_rows);
+
+	if(!series.empty()) {
+	    rv.add_child(thistestcase + "timeseries", series_tree(series, plan.sample_interval));
+	}
+
+	// last error code, useful to identify when something crashes
+	rv.add(thistestcase + "errorcode", errorcode(last_errcode));
+    }
+
+    return rv;
+}
+
+
+ptree Executor::mix( const std::vector<P11Benchmark *> &benchmarks, const MixProfile &profile, const ExecutionPlan &plan, const std::forward_list<std::string> shortlist )
+{
+    ptree rv;
+    std::vector<double> weights;
+    double total_weight = 0.0;
+
+    for(auto &entry: profile.entries()) {
+	weights.push_back(entry.weight);
+	total_weight += entry.weight;
+    }
+
+    for(auto testcase: shortlist) {
+	int last_errcode = CKR_OK;
+	nanosecond_type wallclock_elapsed { 0 };
+	auto &payload = m_vectors.at(testcase);
+
+	std::string mix;
+	for(size_t b=0; b<benchmarks.size(); b++) {
+	    mix += (mix.empty() ? "" : ",") + profile.entries()[b].to_string() + ':' + d2s(weights[b]);
+	}
+
+	std::vector<fact_row_t> fact_rows {
+	    { "mix", "mix", mix },
+	    { "vector size", "vector.size", i2s(payload.size()) },
 	    { "vector unit", "vector.unit", "Byte" },
-	    { "key label", "label", benchmark.label() },
 	    { "number of threads", "threads", i2s(m_numthreads) },
-	    { "iterations/thread", "iterations", i2s(iter) },
-	    { "skipped iterarions/thread", "iterations", i2s(skipiter) },
-	    { "total of iterations", "total iterations", i2s(iter*m_numthreads) }
+	    { "sessions/thread", "sessions", i2s(m_sessions_per_thread) },
 	};
 
-	std::vector<std::tuple<std::string, std::string, Measure<>>> result_rows;
+	if(plan.duration_based()) {
+	    fact_rows.emplace_back( "duration (s)", "duration", d2s(std::chrono::duration<double>(plan.duration).count()) );
+	    fact_rows.emplace_back( "min. iterations/thread", "iterations.minimum", i2s(plan.miniterations) );
+	} else {
+	    fact_rows.emplace_back( "iterations/thread", "iterations", i2s(plan.iterations) );
+	}
+
+	if(plan.thinktime.enabled()) {
+	    fact_rows.emplace_back( "think time", "thinktime.model", plan.thinktime.to_string() );
+	    fact_rows.emplace_back( "think time, mean (ms)", "thinktime.mean", d2s(plan.thinktime.mean().count() / nano_to_milli) );
+	}
+
+	overhead_facts(fact_rows, plan);
+	placement_facts(fact_rows);
+
+	print_facts("Mixed workload", fact_rows);
+
+	ExecutionPlan mix_plan { plan };
+	mix_plan.window = &window();
+
+	std::vector<task_t> tasks;
+	for(int th=0; th<m_numthreads; th++) {
+	    tasks.emplace_back( [&benchmarks, &weights, &payload, &mix_plan] (const std::vector<Session *> &sessions, std::optional<size_t> threadindex, Barrier &startline) {
+				    return P11Benchmark::execute_mix(benchmarks, weights, sessions, payload, mix_plan, threadindex, startline);
+				});
+	}
+
+	auto elapsed_time_array = dispatch(tasks, wallclock_elapsed);
+
+	// dispatch latencies per operation, and sum the TPS achieved by each thread
+	std::vector<std::vector<double>> op_samples(benchmarks.size());
+	double tps = 0.0;
+
+	for(auto &elapsed: elapsed_time_array) {
+	    if(elapsed.errcode != CKR_OK) {
+		last_errcode = elapsed.errcode;
+	    }
+
+	    for(size_t i=0; i<elapsed.records.size(); i++) {
+		op_samples[elapsed.operations[i]].push_back(elapsed.records[i]/nano_to_milli);
+	    }
+
+	    if(elapsed.span > 0) {
+		tps += 1e9 * elapsed.records.size() / elapsed.span;
+	    }
+	}
+
+	size_t total = 0;
+	for(auto &samples: op_samples) {
+	    total += samples.size();
+	}
+
+	ConsoleTable table { "operation", "weight (%)", "iterations", "share (%)", "TPS (Tnx/s)", "latency, average (ms)",
+			     "latency, p50 (ms)", "latency, p90 (ms)", "latency, p99 (ms)", "latency, maximum (ms)" };
+	table.setStyle(1);
+
+	ptree operations;
+
+	for(size_t b=0; b<benchmarks.size(); b++) {
+	    auto &samples = op_samples[b];
+	    double sum = 0.0;
+
+	    for(auto sample: samples) {
+		sum += sample;
+	    }
+
+	    auto share = total > 0 ? static_cast<double>(samples.size()) / total : 0.0;
+	    auto average = samples.empty() ? 0.0 : sum / samples.size();
+	    auto p50 = percentile(samples, 0.50);
+	    auto p90 = percentile(samples, 0.90);
+	    auto p99 = percentile(samples, 0.99);
+	    auto maximum = percentile(samples, 1.0);
+
+	    // the harness overhead is subtracted as in results(), see subtract_overhead()
+	    if(!samples.empty()) {
+		for(auto figure: { &average, &p50, &p90, &p99, &maximum }) {
+		    *figure = std::max(*figure - overhead(plan), 0.0);
+		}
+	    }
+
+	    table += { benchmarks[b]->name() + " with key " + benchmarks[b]->label(), d2s(100 * weights[b] / total_weight, 4),
+		       i2s(samples.size()), d2s(100 * share, 4), d2s(tps * share, 6),
+		       d2s(average,6), d2s(p50,6), d2s(p90,6), d2s(p99,6), d2s(maximum,6) };
 
-	ConsoleTable facts { "property", "value" };
-	facts.setStyle(1);
+	    ptree operation;
+	    operation.add("algorithm", benchmarks[b]->name());
+	    operation.add("label", benchmarks[b]->label());
+	    operation.add("weight", d2s(weights[b]));
+	    operation.add("iterations", samples.size());
+	    operation.add("tps", d2s(tps * share));
+	    operation.add("latency.unit", "ms");
+	    operation.add("latency.average", d2s(average));
+	    operation.add("latency.p50", d2s(p50));
+	    operation.add("latency.p90", d2s(p90));
+	    operation.add("latency.p99", d2s(p99));
+	    operation.add("latency.maximum", d2s(maximum));
+	    operations.push_back(std::make_pair("", operation));
+	}
+
+	std::cout << "Mix results:\n" << table << '\n'
+		  << "combined TPS: " << d2s(tps, 6) << " Tnx/s, wall clock: " << d2s(wallclock_elapsed/nano_to_milli, 6) << " ms\n" << std::endl;
+
+	// all operations together
+	auto series = time_series(elapsed_time_array, plan.sample_interval.count());
+	subtract_overhead(series, overhead(plan));
+	print_series(series, plan.sample_interval);
+
+	// now create json output
+	std::string thistestcase { "mix." + testcase + '.' };
 
+	// adding facts information
 	for(auto &row: fact_rows) {
-	    facts += { std::get<0>(row), std::get<2>(row) };
+	    rv.add(thistestcase + std::get<1>(row), std::get<2>(row) );
 	}
 
-	std::cout << benchmark.name() + " with key " + benchmark.label() << '\n'
-		  << "================================================================================\n"
-		  << "Test case facts:\n"
-		  << facts << std::endl;
+	rv.add(thistestcase + "total iterations", total);
+	rv.add(thistestcase + "tps.global", d2s(tps));
+	rv.add(thistestcase + "wallclock", d2s(wallclock_elapsed/nano_to_milli));
+	rv.add_child(thistestcase + "operations", operations);
+	if(!series.empty()) {
+	    rv.add_child(thistestcase + "timeseries", series_tree(series, plan.sample_interval));
+	}
 
-	greenlight = false;	// prepare threads to sync on "green light"
+	// last error code, useful to identify when something crashes
+	rv.add(thistestcase + "errorcode", errorcode(last_errcode));
+    }
 
-	for(th=0; th<m_numthreads;th++) {
-	    // make a copy of the benchmark object, for each thread
-	    benchmark_array[th] = benchmark.clone(); // get a "clone" of the object
+    return rv;
+}
 
-	    if(m_generate_session_keys) {
-		future_array[th] = std::async( std::launch::async,
-					       &P11Benchmark::execute,
-					       benchmark_array[th],
-					       m_sessions[th].get(),
-					       m_vectors.at(testcase),
-					       iter,
-					       skipiter,
-					       std::optional<size_t>(th));
-	    } else {
-		future_array[th] = std::async( std::launch::async,
-					       &P11Benchmark::execute,
-					       benchmark_array[th],
-					       m_sessions[th].get(),
-					       m_vectors.at(testcase),
-					       iter,
-					       skipiter,
-					       std::nullopt);
-	    }
-	}
-
-	// start the wall clock
-
-	wallclock_t.start();
-	// give start signal
-	{
-	    std::lock_guard<std::mutex> greenlight_lck(greenlight_mtx);
-	    greenlight = true;
-	    greenlight_cond.notify_all();
-	}
-
-	// recover futures
-	for(th=0;th<m_numthreads;th++) {
-	    elapsed_time_array[th] = future_array[th].get();
-	}
-
-	// stop wallclock and measure elapsed time
-	wallclock_t.stop();
-	wallclock_elapsed = wallclock_t.elapsed().wall;
-
-	bacc::accumulator_set< double, bacc::stats<
-	    bacc::tag::mean,
-	    bacc::tag::min,
-	    bacc::tag::max,
-	    bacc::tag::count,
-	    bacc::tag::variance > > acc;
-
-	// helper map table for statistics
-	std::map<std::string, std::function<double()> > stats {
-	    { "min",   [&acc] () { return bacc::min(acc);  }},
-	    { "mean",  [&acc] () { return bacc::mean(acc); }},
-	    { "max",   [&acc] () { return bacc::max(acc);  }},
-	    { "range", [&acc] () { return (bacc::max(acc) - bacc::min(acc)); }},
-	    { "svar",   [&acc] () {
-			   auto n = bacc::count(acc);
-			   double f = static_cast<double>(n) / (n - 1);
-			   return f * bacc::variance(acc); }},
-	    { "sstddev", [&stats] () { return std::sqrt(stats["svar"]()); }},
-	    // note: for error, we take k=2 so 95% of measures are within interval
-	    { "error", [&stats] () { return std::sqrt(stats["svar"]()/static_cast<double>( stats["count"]() ))*2; }},
-	    { "count", [&acc] () { return bacc::count(acc); }},
-	};
 
-	// compute statistics
-	for(auto elapsed: elapsed_time_array) {
-	    if(elapsed.second != CKR_OK) {
-		last_errcode = elapsed.second;
-		wallclock_elapsed = 0;
-		break;		// something wrong happened, no need to carry on
-	    }
-
-	    for(auto it=elapsed.first.begin(); it!=elapsed.first.end(); ++it) {
-		acc(*it/nano_to_milli);
-	    }
-	}
-
-	auto vector_size = m_vectors.at(testcase).size();
-	auto stats_count = stats["count"]();
-
-	// timer_res is the resolution of the timer
-	Measure<> timer_res(m_timer_res, m_timer_res_err, "ns");
-	result_rows.emplace_back(std::forward_as_tuple("timer resolution", "timer resolution", std::move(timer_res)));
-
-	// epsilon represents the max resolution we have for a latency measurement.
-	// It sums the resolution and its standard error to it,
-	// ( = 2x stddev on sample mean, to reach 95% of interval)
-	// it is multiplied by two, as an interval is measured by making two time measurements. Therefore the
-	// uncertainties adds up.
-	// It is converted to milliseconds.
-	auto epsilon = 2 * (m_timer_res + m_timer_res_err ) / nano_to_milli;
-
-	// if the statistical error is less than epsilon, then it is no more significant,
-	// as the measure is blurred by the resolution of the timer.
-	// In which case, the error on latency is topped to epsilon
-	auto latency_avg_val = stats["mean"]();
-	auto latency_avg_err = stats["error"]() < epsilon ? epsilon : stats["error"]();
-	Measure<> latency_avg(latency_avg_val, latency_avg_err, "ms");
-	result_rows.emplace_back(std::forward_as_tuple("latency, average", "latency.average", std::move(latency_avg)));
-	// minimum and maximum are measured directly. their error depends directly upon
-	// the measurement of two times, i.e. t2-t1. Therefore, the error on that measurment
-	// equals twice the precision.
-	auto latency_min_val = stats["min"]();
-	auto latency_min_err = epsilon;
-	Measure<> latency_min(latency_min_val, latency_min_err, "ms");
-	result_rows.emplace_back(std::forward_as_tuple("latency, minimum", "latency.minimum", std::move(latency_min)));
-	auto latency_max_val = stats["max"]();;
-	auto latency_max_err =  epsilon;
-	Measure<> latency_max(latency_max_val, latency_max_err, "ms");
-	result_rows.emplace_back(std::forward_as_tuple("latency, maximum", "latency.maximum", std::move(latency_max)));
-	// TPS is the number of "transactions" per second.
-	// the meaning of "transaction" depends upon the tested API/algorithm
+// combine(): combine the measures of a quantity obtained over several runs.
+// extrema are kept as such. Other measures are averaged, and their error is the largest of
+// the propagated error and the spread observed between runs (k=2), as runs may drift.
+static Measure<> combine(const std::string &name, std::vector<Measure<>> &measures)
+{
+    if(name == "latency.minimum") {
+	return *std::min_element(measures.begin(), measures.end(), [] (auto &a, auto &b) { return a.value() < b.value(); });
+    } else if(name == "latency.maximum") {
+	return *std::max_element(measures.begin(), measures.end(), [] (auto &a, auto &b) { return a.value() < b.value(); });
+    }
 
-	// the statistics are computed over all threads. Therefore, the TPS it yields is per thread.
-	auto tps_thread_avg_val = 1000 / stats["mean"]();
-	auto tps_thread_avg_err = 1000 * latency_avg_err / (latency_avg_val*latency_avg_val) ;
-	Measure<> tps_thread_avg(tps_thread_avg_val, tps_thread_avg_err, "Tnx/s");
-	result_rows.emplace_back(std::forward_as_tuple("TPS/thread, average", "tps.thread", std::move(tps_thread_avg)));
-	// global TPS is simply obtained by multiplying TPS/thread by the number of threads
-	auto tps_global_avg_val = tps_thread_avg_val * m_numthreads;
-	auto tps_global_avg_err = tps_thread_avg_err * m_numthreads;
-	Measure<> tps_global_avg(tps_global_avg_val, tps_global_avg_err, "Tnx/s");
-	result_rows.emplace_back(std::forward_as_tuple("global TPS, average", "tps.global", std::move(tps_global_avg)));
-	// throughput is obtained by multiplying TPS by vector size.
-	// Note that it is probably meaningful only to bulk encryption algorithms.
-	auto throughput_thread_avg_val = 1000 * vector_size / stats["mean"]();
-	auto throughput_thread_avg_err = 1000 * vector_size * latency_avg_err / (latency_avg_val*latency_avg_val);
-	Measure<> throughput_thread_avg(throughput_thread_avg_val, throughput_thread_avg_err, "Byte/s");
-	result_rows.emplace_back(std::forward_as_tuple("throughput/thread, average", "throughput.thread", std::move(throughput_thread_avg)));
+    std::vector<double> values;
+    double err2 = 0.0;
 
-	auto throughput_global_avg_val = throughput_thread_avg_val * m_numthreads;
-	auto throughput_global_avg_err = throughput_thread_avg_err * m_numthreads;
-	Measure<> throughput_global_avg(throughput_global_avg_val, throughput_global_avg_err, "Byte/s");
-	result_rows.emplace_back(std::forward_as_tuple("global throughput, average", "throughput.global", std::move(throughput_global_avg)));
+    for(auto &measure: measures) {
+	values.push_back(measure.value());
+	err2 += measure.error() * measure.error();
+    }
+
+    auto n = measures.size();
+    auto mean = average(values, 0.0, measures.front().unit());
+    auto error = std::max(std::sqrt(err2) / n, n > 1 ? mean.error() : 0.0);
+
+    return Measure<>(mean.value(), error, measures.front().unit());
+}
+
+
+ptree Executor::compare( P11Benchmark &benchmark, Executor &other, const ExecutionPlan &plan, size_t rounds,
+			 const std::pair<std::string, std::string> &targets, const std::forward_list<std::string> shortlist )
+{
+    ptree rv;
+
+    // only measures describing the token are compared, not those describing the run itself
+    auto compared = [] (const std::string &name) {
+			return name.rfind("latency.", 0) == 0
+			    || name.rfind("tps.", 0) == 0
+			    || name.rfind("throughput.", 0) == 0
+			    || name.rfind("goodput.", 0) == 0
+			    || name == "deadline.met"
+			    || name == "errors.rate"
+			    || name == "utilization";
+		    };
+
+    for(auto testcase: shortlist) {
+	int last_errcode = CKR_OK;
+
+	auto fact_rows = testcase_facts(benchmark, testcase, plan);
+	fact_rows.emplace_back( "A", "ab.a.target", targets.first );
+	fact_rows.emplace_back( "B", "ab.b.target", targets.second );
+	fact_rows.emplace_back( "rounds", "ab.rounds", i2s(rounds) );
+
+	print_facts(benchmark, fact_rows);
+
+	// measures obtained at each run, for A (0) and B (1), and their names in order of appearance
+	std::map<std::string, std::vector<Measure<>>> measures[2];
+	std::vector<std::pair<std::string, std::string>> names;
+	ptree runs;
 
-	// wallclock_elapsed_ms is the total time elapsed (in ms).
-	Measure<> wallclock_elapsed_ms( wallclock_elapsed/nano_to_milli, epsilon, "ms" );
-	result_rows.emplace_back(std::forward_as_tuple("wall clock", "wallclock", std::move(wallclock_elapsed_ms)));
+	for(size_t round=0; round<rounds && last_errcode == CKR_OK; round++) {
+	    for(size_t turn=0; turn<2; turn++) {
+		// ABBA order: A runs first in even rounds, B in odd rounds
+		size_t side = (round + turn) % 2;
+		Executor &executor = side == 0 ? *this : other;
+		nanosecond_type wallclock_elapsed { 0 };
+		int run_errcode = CKR_OK;
 
-	ConsoleTable results{"measure", "value", "error (+/-)", "unit", "rel. error" };
-	results.setStyle(1);
+		auto elapsed_time_array = executor.run(benchmark, testcase, executor.thread_plans(plan, executor.m_numthreads), wallclock_elapsed);
+		auto result_rows = executor.results(elapsed_time_array, wallclock_elapsed, executor.m_vectors.at(testcase).size(), plan, run_errcode);
 
-	for(auto &row: result_rows) {
-	    results += {
-		std::get<0>(row),
-		    d2s(std::get<2>(row).value(),12),
-		    d2s(std::get<2>(row).error(),12),
-		std::get<2>(row).unit(),
-		d2s(std::get<2>(row).relerr()*100,3)+'%'  };
+		ptree point;
+		point.add("round", round + 1);
+		point.add("side", side == 0 ? "A" : "B");
+		add_results(point, "", result_rows);
+		point.add("errorcode", errorcode(run_errcode));
+		runs.push_back(std::make_pair("", point));
+
+		if(run_errcode != CKR_OK) {
+		    std::cout << "round " << round + 1 << ", " << (side == 0 ? 'A' : 'B') << ": " << errorcode(run_errcode) << std::endl;
+		    last_errcode = run_errcode;
+		    break;	// no need to carry on, the comparison would be unbalanced
+		}
+
+		for(auto &row: result_rows) {
+		    auto &name = std::get<1>(row);
+		    if(compared(name)) {
+			if(std::find_if(names.begin(), names.end(), [&name] (auto &n) { return n.second == name; }) == names.end()) {
+			    names.emplace_back(std::get<0>(row), name);
+			}
+			measures[side][name].push_back(std::get<2>(row));
+			if(name == "tps.global") {
+			    std::cout << "round " << round + 1 << ", " << (side == 0 ? 'A' : 'B') << ": global TPS "
+				      << d2s(std::get<2>(row).value(),12) << " +/- " << d2s(std::get<2>(row).error(),12) << std::endl;
+			}
+		    }
+		}
+	    }
+	}
+
+	ConsoleTable comparison { "measure", "A", "B", "unit", "B/A", "error (+/-)", "significant" };
+	comparison.setStyle(1);
+
+	std::vector<result_row_t> rows[2];
+	ptree ratios;
+
+	for(auto &[label, name]: names) {
+	    if(measures[0][name].empty() || measures[1][name].empty()) {
+		continue;
+	    }
+
+	    auto a = combine(name, measures[0][name]);
+	    auto b = combine(name, measures[1][name]);
+
+	    // errors are given with k=2: the difference is significant (95%) when it exceeds their combination
+	    bool significant = std::abs(b.value() - a.value()) > std::hypot(a.error(), b.error());
+
+	    // the relative errors on A and B are independent, they are added in quadrature
+	    auto ratio = a.value() > 0.0 ? b.value() / a.value() : 0.0;
+	    auto ratio_err = ratio * std::hypot(a.relerr(), b.relerr());
+
+	    comparison += { label,
+			    d2s(a.value(),12) + " +/- " + d2s(a.error(),12),
+			    d2s(b.value(),12) + " +/- " + d2s(b.error(),12),
+			    a.unit(),
+			    ratio > 0.0 ? d2s(ratio,4) : "n/a",
+			    ratio > 0.0 ? d2s(ratio_err,2) : "n/a",
+			    significant ? "yes" : "no" };
+
+	    ratios.add(name + ".value", d2s(ratio));
+	    ratios.add(name + ".error", d2s(ratio_err));
+	    ratios.add(name + ".significant", significant ? "true" : "false");
+
+	    rows[0].emplace_back(label, name, a);
+	    rows[1].emplace_back(label, name, b);
 	}
 
-	std::cout << "Test case results:\n" << results << std::endl;
+	std::cout << "A/B comparison:\n" << comparison << std::endl;
 
 	// now create json output
 	std::string thistestcase { benchmark.label() + '.' + testcase + '.' };
@@ -274,13 +2480,10 @@ ptree Executor::benchmark( P11Benchmark &benchmark, const size_t iter, const siz
 	    rv.add(thistestcase + std::get<1>(row), std::get<2>(row) );
 	}
 
-	// adding results information
-	for(auto &row: result_rows) {
-	    rv.add<double>(thistestcase + std::get<1>(row) + ".value",  std::get<2>(row).value());
-	    rv.add(thistestcase + std::get<1>(row) + ".unit",   std::get<2>(row).unit());
-	    rv.add(thistestcase + std::get<1>(row) + ".error",  d2s(std::get<2>(row).error()));
-	    rv.add(thistestcase + std::get<1>(row) + ".relerr", d2s(std::get<2>(row).relerr()));
-	}
+	add_results(rv, thistestcase + "ab.a.", rows[0]);
+	add_results(rv, thistestcase + "ab.b.", rows[1]);
+	rv.add_child(thistestcase + "ab.ratio", ratios);
+	rv.add_child(thistestcase + "ab.runs", runs);
 
 	// last error code, useful to identify when something crashes
 	rv.add(thistestcase + "errorcode", errorcode(last_errcode));
@@ -22,37 +22,95 @@
 #define EXECUTOR_H
 
 #include <forward_list>
+#include <tuple>
+#include <optional>
 #include <botan/p11_types.h>
 #include <boost/property_tree/ptree.hpp>
 #include "p11benchmark.hpp"
+#include "measure.hpp"
+#include "ratecoverage.hpp"
+#include "rampprofile.hpp"
+#include "threadcoverage.hpp"
+#include "workerpool.hpp"
+#include "mixprofile.hpp"
+#include "processgroup.hpp"
 #include "../config.h"
 
 using namespace Botan::PKCS11;
 using namespace boost::property_tree;
 
+// a fact is a property of the test case: displayed name, JSON name and value
+using fact_row_t = std::tuple<std::string, std::string, std::string>;
+// a result is a measure: displayed name, JSON name and measure
+using result_row_t = std::tuple<std::string, std::string, Measure<>>;
+
+// overhead_t: distribution of the harness overhead around each call, in ns. See Executor::calibrate()
+struct overhead_t {
+    double mean;
+    double error;		// on the mean, k=2
+    double minimum;
+    double median;
+    double p99;
+    double maximum;
+};
+
 class Executor
 {
     const std::map<const std::string, const std::vector<uint8_t> > &m_vectors;
     std::vector<std::unique_ptr<Session> > &m_sessions;
     const int m_numthreads;
+    const int m_sessions_per_thread;
     double m_timer_res;
     double m_timer_res_err;
     bool m_generate_session_keys;
+    const Placement &m_placement;
+    ProcessGroup *m_group;	// when running several processes, the group this one belongs to
+    Watchdog *m_watchdog;	// if any, flags calls stuck for too long
+    std::optional<overhead_t> m_overhead; // harness overhead, once calibrated
+    std::optional<std::string> m_password; // to log in sessions reopened by a retry policy, see reopen_with()
+    RequestQueue m_requests;	// requests issued by logical clients, in pipelined mode
+    ActiveWindow m_window;	// shared by threads of a run. With several processes, the one of the group is used instead
+    WorkerPool m_pool;		// one worker per thread, bound to its sessions, reused accross test cases and benchmarks
+
+    inline size_t processes() const { return m_group ? m_group->size() : 1; }
+    inline ActiveWindow &window() { return m_group ? m_group->window() : m_window; }
+
+    std::vector<fact_row_t> testcase_facts( P11Benchmark &benchmark, const std::string &testcase, const ExecutionPlan &plan );
+    void placement_facts( std::vector<fact_row_t> &fact_rows );
+    void overhead_facts( std::vector<fact_row_t> &fact_rows, const ExecutionPlan &plan );
+    double overhead( const ExecutionPlan &plan ) const;
+    std::vector<ExecutionPlan> thread_plans( const ExecutionPlan &plan, size_t numthreads );
+    std::vector<benchmark_result_t> dispatch( std::vector<task_t> &tasks, nanosecond_type &wallclock_elapsed, RequestQueue *requests = nullptr, bool restart = true );
+    std::vector<benchmark_result_t> run( P11Benchmark &benchmark, const std::string &testcase, const std::vector<ExecutionPlan> &plans, nanosecond_type &wallclock_elapsed, RequestQueue *requests = nullptr, bool restart = true );
+    std::vector<benchmark_result_t> adaptive_run( P11Benchmark &benchmark, const std::string &testcase, const ExecutionPlan &plan, nanosecond_type &wallclock_elapsed, std::vector<fact_row_t> &target_rows );
+    std::vector<result_row_t> results( const std::vector<benchmark_result_t> &elapsed_time_array, nanosecond_type wallclock_elapsed, size_t vector_size, const ExecutionPlan &plan, int &last_errcode );
+    std::vector<result_row_t> pipeline_results( const std::vector<benchmark_result_t> &elapsed_time_array, nanosecond_type wallclock_elapsed, size_t vector_size, const ExecutionPlan &plan, int &last_errcode );
 
 public:
     Executor( const std::map<const std::string,
 	      const std::vector<uint8_t> > &vectors,
 	      std::vector<std::unique_ptr<Session> > &sessions,
 	      const int numthreads,
+	      const int sessions_per_thread,
 	      std::pair<double, double> precision,
-	      bool generate_session_keys)
+	      bool generate_session_keys,
+	      const Placement &placement,
+	      ProcessGroup *group = nullptr,
+	      Watchdog *watchdog = nullptr,
+	      Trace *trace = nullptr,
+	      const std::string &arm = "")
 	:
 	m_vectors(vectors),
 	m_sessions(sessions),
 	m_numthreads(numthreads),
+	m_sessions_per_thread(sessions_per_thread),
 	m_timer_res(precision.first),
 	m_timer_res_err(precision.second),
-	m_generate_session_keys(generate_session_keys)
+	m_generate_session_keys(generate_session_keys),
+	m_placement(placement),
+	m_group(group),
+	m_watchdog(watchdog),
+	m_pool(sessions, sessions_per_thread, generate_session_keys, placement, watchdog, trace, arm)
     { }
 
     Executor( const Executor &) = delete;
@@ -63,7 +121,36 @@ public:
 
     double precision() { return m_timer_res + m_timer_res_err; }
 
-    ptree benchmark( P11Benchmark &benchmark, const size_t iter, const size_t skipiter, const std::forward_list<std::string> shortlist );
+    // reopen_with(): when a retry policy reopens a lost session, the new session is logged in with this password
+    inline void reopen_with(const std::string &password) { m_password = password; }
+
+    // calibrate(): run the benchmark loop with an empty operation, on all threads, and measure the harness overhead
+    // timed with each call. Once calibrated, the overhead is subtracted from latency, when the plan says so.
+    overhead_t calibrate( size_t iterations );
+
+    ptree benchmark( P11Benchmark &benchmark, const ExecutionPlan &plan, const std::forward_list<std::string> shortlist );
+
+    // rate_sweep(): run the benchmark in open loop, for each offered rate, and build the load curve
+    ptree rate_sweep( P11Benchmark &benchmark, const ExecutionPlan &plan, RateCoverage &rates, const std::forward_list<std::string> shortlist );
+
+    // ramp(): run the benchmark while adding threads at regular intervals, and report each step
+    ptree ramp( P11Benchmark &benchmark, const ExecutionPlan &plan, const RampProfile &profile, const std::forward_list<std::string> shortlist );
+
+    // threads_sweep(): run the benchmark at each concurrency level, and fit the Universal Scalability Law to the TPS curve
+    ptree threads_sweep( P11Benchmark &benchmark, const ExecutionPlan &plan, ThreadCoverage &levels, const std::forward_list<std::string> shortlist );
+
+    // pipeline(): logical clients keep requests in flight, served by carrier threads (one per session group)
+    ptree pipeline( P11Benchmark &benchmark, const ExecutionPlan &plan, size_t clients, size_t inflight, const std::forward_list<std::string> shortlist );
+
+    // mix(): run a weighted mix of benchmarks concurrently, and report per-operation latency and combined TPS.
+    // benchmarks are given in the same order as the profile entries.
+    ptree mix( const std::vector<P11Benchmark *> &benchmarks, const MixProfile &profile, const ExecutionPlan &plan, const std::forward_list<std::string> shortlist );
+
+    // compare(): run the benchmark alternately on this executor (A) and on another one (B), in ABBA order to cancel drift,
+    // and report each measure for A and B, with the B/A ratio and whether the difference is significant.
+    // targets describe A and B, for facts.
+    ptree compare( P11Benchmark &benchmark, Executor &other, const ExecutionPlan &plan, size_t rounds,
+		   const std::pair<std::string, std::string> &targets, const std::forward_list<std::string> shortlist );
 
 };
 
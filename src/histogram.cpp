@@ -0,0 +1,163 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// histogram.cpp: a log-bucketed latency histogram, in the manner of HdrHistogram
+
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include "histogram.hpp"
+
+constexpr int LatencyHistogram::sub_bucket_half_magnitude;
+constexpr std::int64_t LatencyHistogram::sub_bucket_count;
+constexpr std::int64_t LatencyHistogram::sub_bucket_half_count;
+constexpr std::int64_t LatencyHistogram::highest;
+constexpr int LatencyHistogram::bucket_count;
+constexpr size_t LatencyHistogram::range_size;
+constexpr size_t LatencyHistogram::range_count;
+
+// bucket_index(): the power of two bucket of a value. Values below sub_bucket_count all go to bucket 0,
+// where sub-buckets are 1 ns wide.
+int LatencyHistogram::bucket_index(std::int64_t value)
+{
+    const auto bits = 64 - __builtin_clzll(static_cast<unsigned long long>(value | (sub_bucket_count - 1)));
+    return bits - (sub_bucket_half_magnitude + 1);
+}
+
+
+size_t LatencyHistogram::counts_index(std::int64_t value)
+{
+    const auto bucket = bucket_index(value);
+    const auto sub_bucket = value >> bucket;
+    // bucket 0 uses all its sub-buckets, others use their upper half only: the lower half overlaps the previous bucket
+    return static_cast<size_t>(((bucket + 1) << sub_bucket_half_magnitude) + (sub_bucket - sub_bucket_half_count));
+}
+
+
+std::int64_t LatencyHistogram::lowest_equivalent(size_t index)
+{
+    auto bucket = static_cast<int>(index >> sub_bucket_half_magnitude) - 1;
+    auto sub_bucket = static_cast<std::int64_t>(index & (sub_bucket_half_count - 1)) + sub_bucket_half_count;
+
+    if(bucket < 0) {
+	sub_bucket -= sub_bucket_half_count;
+	bucket = 0;
+    }
+
+    return sub_bucket << bucket;
+}
+
+
+std::int64_t LatencyHistogram::resolution(std::int64_t value)
+{
+    return std::int64_t(1) << bucket_index(value < 0 ? 0 : value);
+}
+
+
+void LatencyHistogram::clear()
+{
+    for(auto &range: m_counts) {
+	std::fill(range.begin(), range.end(), 0);
+    }
+    m_total = 0;
+    m_max = 0;
+}
+
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    other.for_each([this] (size_t index, std::uint64_t count) {
+		       if(count > 0) {
+			   counter(index) += count;
+		       }
+		   });
+
+    m_total += other.m_total;
+    m_max = other.m_max > m_max ? other.m_max : m_max;
+}
+
+
+std::int64_t LatencyHistogram::percentile(double p) const
+{
+    if(m_total == 0) {
+	return 0;
+    }
+
+    const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(p * m_total)));
+    std::uint64_t seen = 0;
+
+    for(size_t r=0; r<m_counts.size(); r++) {
+	for(size_t i=0; i<m_counts[r].size(); i++) {
+	    seen += m_counts[r][i];
+	    if(seen >= rank) {
+		auto lowest = lowest_equivalent(r * range_size + i);
+		// the highest equivalent value, but no more than the maximum recorded
+		return std::min(lowest + resolution(lowest) - 1, m_max);
+	    }
+	}
+    }
+
+    return m_max;
+}
+
+
+std::vector<std::pair<std::int64_t, std::uint64_t> > LatencyHistogram::cdf() const
+{
+    std::vector<std::pair<std::int64_t, std::uint64_t> > rv;
+    std::uint64_t seen = 0;
+
+    for_each([this, &rv, &seen] (size_t index, std::uint64_t count) {
+		 if(count > 0) {
+		     seen += count;
+		     auto lowest = lowest_equivalent(index);
+		     rv.emplace_back(std::min(lowest + resolution(lowest) - 1, m_max), seen);
+		 }
+	     });
+
+    return rv;
+}
+
+
+std::vector<std::pair<size_t, std::uint64_t> > LatencyHistogram::sparse() const
+{
+    std::vector<std::pair<size_t, std::uint64_t> > rv;
+
+    for_each([&rv] (size_t index, std::uint64_t count) {
+		 if(count > 0) {
+		     rv.emplace_back(index, count);
+		 }
+	     });
+
+    return rv;
+}
+
+
+void LatencyHistogram::from_sparse(const std::vector<std::pair<size_t, std::uint64_t> > &counters, std::int64_t max)
+{
+    clear();
+
+    for(auto [index, count]: counters) {
+	if(index >= range_count * range_size) {
+	    throw std::out_of_range("histogram counter out of range");
+	}
+	counter(index) += count;
+	m_total += count;
+    }
+
+    m_max = max;
+}
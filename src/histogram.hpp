@@ -0,0 +1,112 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// histogram.hpp: a log-bucketed latency histogram, in the manner of HdrHistogram
+
+#if !defined(HISTOGRAM_H)
+#define HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+// LatencyHistogram counts latencies, in ns, with 3 significant digits: values are grouped in buckets
+// covering powers of two, each split in 1024 sub-buckets of equal width, so that the width of a sub-bucket
+// is less than 1/1024 of the values it holds. Latencies from 1 ns to about 2.4 hours are tracked,
+// in a bounded amount of memory (at most 280 kB), whatever the number of values recorded; larger ones are
+// counted as the highest trackable value. Counters are allocated by ranges of 1024 (8 kB), when a value first
+// falls in the range: as latencies of a test case seldom span more than a few powers of two, a histogram
+// usually takes a few tens of kB.
+class LatencyHistogram
+{
+public:
+    static constexpr int sub_bucket_half_magnitude = 10; // 3 significant digits: 2048 sub-buckets per bucket
+    static constexpr std::int64_t sub_bucket_count = std::int64_t(1) << (sub_bucket_half_magnitude + 1);
+    static constexpr std::int64_t sub_bucket_half_count = sub_bucket_count / 2;
+    static constexpr std::int64_t highest = std::int64_t(1) << 43; // about 2.4 hours
+    static constexpr int bucket_count = 43 - (sub_bucket_half_magnitude + 1) + 1;
+
+private:
+    static constexpr size_t range_size = sub_bucket_half_count;
+    static constexpr size_t range_count = bucket_count + 1;
+
+    std::vector<std::vector<std::uint64_t> > m_counts; // by range, empty until a value falls in it
+    std::uint64_t m_total { 0 };
+    std::int64_t m_max { 0 };
+
+    static int bucket_index(std::int64_t value);
+    static size_t counts_index(std::int64_t value);
+    static std::int64_t lowest_equivalent(size_t index);
+
+    // counter(): the counter of an index, allocating its range if needed
+    inline std::uint64_t &counter(size_t index) {
+	if(m_counts.empty()) {
+	    m_counts.resize(range_count);
+	}
+	auto &range = m_counts[index / range_size];
+	if(range.empty()) {
+	    range.resize(range_size);
+	}
+	return range[index % range_size];
+    }
+
+    // for_each(): call f(index, count) for each counter allocated, by increasing index
+    template<typename F> void for_each(F f) const {
+	for(size_t r=0; r<m_counts.size(); r++) {
+	    for(size_t i=0; i<m_counts[r].size(); i++) {
+		f(r * range_size + i, m_counts[r][i]);
+	    }
+	}
+    }
+
+public:
+    // record(): count one value
+    inline void record(std::int64_t value) {
+	value = value < 0 ? 0 : (value >= highest ? highest - 1 : value);
+	counter(counts_index(value))++;
+	m_total++;
+	m_max = value > m_max ? value : m_max;
+    }
+
+    // clear(): forget the values counted, keeping the counters allocated
+    void clear();
+
+    // merge(): add the values counted by another histogram
+    void merge(const LatencyHistogram &other);
+
+    inline std::uint64_t count() const { return m_total; }
+    inline std::int64_t max() const { return m_max; }
+
+    // percentile(): the value below which a share p (0<p<=1) of the values fall,
+    // given as the highest value equivalent to it, i.e. counted in the same sub-bucket
+    std::int64_t percentile(double p) const;
+
+    // resolution(): the width of the sub-bucket holding a value, i.e. the error on values reported
+    static std::int64_t resolution(std::int64_t value);
+
+    // cdf(): for each sub-bucket holding values, its highest equivalent value, and the number of values
+    // up to that sub-bucket
+    std::vector<std::pair<std::int64_t, std::uint64_t> > cdf() const;
+
+    // sparse(), from_sparse(): the non-empty counters, as (index, count) pairs, to exchange histograms
+    std::vector<std::pair<size_t, std::uint64_t> > sparse() const;
+    void from_sparse(const std::vector<std::pair<size_t, std::uint64_t> > &counters, std::int64_t max);
+};
+
+#endif // HISTOGRAM_H
@@ -293,7 +293,7 @@ void KeyGenerator::generate_key_generic(KeyGenerator::KeyType keytype, std::stri
 {
     int th;
     bool rv = true;
-    std::vector<std::future<bool> > future_array(m_numthreads);
+    std::vector<std::future<bool> > future_array(m_numthreads * m_slots);
 
     // because I'm lazy, let's use decltype() to define the function pointer...
     using fnptr = decltype( &KeyGenerator::generate_rsa_keypair );
@@ -314,20 +314,23 @@ void KeyGenerator::generate_key_generic(KeyGenerator::KeyType keytype, std::stri
 
 	thread_specific_alias << alias << "-th-" << std::setw(5) << std::setfill('0') << th;
 
-	future_array[th] = std::async( std::launch::async,
-				       chooser(keytype),
-				       this,
-				       thread_specific_alias.str(),
-				       bits,
-				       curve,
-				       m_sessions[th].get());
+	// session keys are only visible on their token: the key is generated on every slot
+	for(int s=0; s<m_slots; s++) {
+	    future_array[th*m_slots+s] = std::async( std::launch::async,
+						     chooser(keytype),
+						     this,
+						     thread_specific_alias.str(),
+						     bits,
+						     curve,
+						     m_sessions[(th*m_slots+s)*m_sessions_per_slot].get());
+	}
     }
 
     // recover futures. If one is false, return false
     // TODO: replace with exception
 
-    for(th=0;th<m_numthreads;th++) {
-	if(future_array[th].get() == false) {
+    for(size_t f=0;f<future_array.size();f++) {
+	if(future_array[f].get() == false) {
 	    throw KeyGenerationException{"could not generate key"};
 	}
     }
@@ -48,6 +48,8 @@ public:
 private:
     std::vector<std::unique_ptr<Session> > &m_sessions;
     const int m_numthreads;
+    const int m_slots;
+    const int m_sessions_per_slot;
     const Implementation::Vendor m_vendor;
 
     bool generate_rsa_keypair(std::string alias, unsigned int bits, std::string unused, Session *session);
@@ -61,10 +63,14 @@ private:
 
 public:
 
+    // sessions of thread th on slot s are found at (th*slots + s)*sessions_per_slot, onwards.
+    // keys are generated for each thread, on each slot.
     KeyGenerator( std::vector<std::unique_ptr<Session> > &sessions,
 		  const int numthreads,
+		  const int slots,
+		  const int sessions_per_slot,
 		  const Implementation::Vendor vendor):
-	m_sessions(sessions), m_numthreads(numthreads), m_vendor(vendor) { }
+	m_sessions(sessions), m_numthreads(numthreads), m_slots(slots), m_sessions_per_slot(sessions_per_slot), m_vendor(vendor) { }
 
     KeyGenerator( const KeyGenerator &) = delete;
     KeyGenerator& operator=( const KeyGenerator &) = delete;
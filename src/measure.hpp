@@ -37,17 +37,18 @@ public:
 	m_error(err),
 	m_unit(unit),
 	m_error_precision(e_precision),
-	m_value_order(ceil(log10(val))),
-	m_error_order(ceil(log10(err))) {
+	m_value_order(val == 0 ? 0 : ceil(log10(val))),
+	m_error_order(err == 0 ? 0 : ceil(log10(err))) {
 
 	auto digits = [](T n) -> int { return ceil(abs(log10(n))) * copysign(1,log10(n)); };
 
-	m_precision = digits(val) - digits(err) + 1;
+	// a null value (e.g. no call within a deadline) is exact to the precision of its error
+	m_precision = val == 0 || err == 0 ? m_error_precision : digits(val) - digits(err) + 1;
     }
 
     inline const T value() { return rounder(m_value, m_precision); }
     inline const T error() { return rounder(m_error, m_error_precision); }
-    inline const T relerr() { return fabs(error()/value()); }
+    inline const T relerr() { return m_error == 0 ? 0 : fabs(error()/value()); }
     inline std::pair<T,T> value_error() { return std::make_pair(value(),error()); }
     inline const S unit() { return m_unit; }
 
@@ -57,6 +58,9 @@ private:
 
     // rounder() is used to chop figures from n, given a wanted precision (p)
     T rounder(T n, T p) const {
+	if(n == 0) {
+	    return 0;
+	}
         auto shift = p - ceil(log10(n));
 	return round(n*pow(10,shift)) / pow(10,shift);
     }
@@ -0,0 +1,109 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// mixprofile.cpp: a class to describe a weighted mix of benchmarks, e.g. "hmac-256:60,rsa-2048/oaepunw:40"
+
+#include <cstdlib>
+#include <map>
+#include <boost/tokenizer.hpp>
+#include "mixprofile.hpp"
+
+// benchmarks do not know the test case name they were created for;
+// we recognize them by their name instead.
+static const std::map<const std::string, const std::string> test_names {
+    { "rsa", "RSA PKCS#1 Signature" },
+    { "oaep", "RSA PKCS#1 OAEP decryption" },
+    { "oaepsha1", "RSA PKCS#1 OAEP decryption (SHA1)" },
+    { "oaepsha256", "RSA PKCS#1 OAEP decryption (SHA256)" },
+    { "oaepenc", "RSA PKCS#1 OAEP encryption" },
+    { "oaepencsha1", "RSA PKCS#1 OAEP encryption (SHA1)" },
+    { "oaepencsha256", "RSA PKCS#1 OAEP encryption (SHA256)" },
+    { "oaepunw", "RSA PKCS#1 OAEP unwrap" },
+    { "oaepunwsha1", "RSA PKCS#1 OAEP unwrap (SHA1)" },
+    { "oaepunwsha256", "RSA PKCS#1 OAEP unwrap (SHA256)" },
+    { "jwe", "JWE(RFC7516)" },
+    { "jweoaepsha1", "JWE(RFC7516): RSA PKCS OAEP(SHA1)" },
+    { "jweoaepsha256", "JWE(RFC7516): RSA PKCS OAEP(SHA256)" },
+    { "ecdsa", "ECDSA Signature" },
+    { "ecdh", "ECDH1 Derive" },
+    { "hmac", "HMAC" },
+    { "des", "DES3 Encryption" },
+    { "desecb", "DES3 Encryption (CKM_DES3_ECB)" },
+    { "descbc", "DES3 Encryption (CKM_DES3_CBC)" },
+    { "aes", "AES" },
+    { "aesecb", "AES Encryption (CKM_AES_ECB)" },
+    { "aescbc", "AES Encryption (CKM_AES_CBC)" },
+    { "aesgcm", "AES Authenticated Encryption (CKM_AES_GCM)" },
+    { "xorder", "XOR Key and Data Derive" },
+    { "rand", "random numbers" },
+};
+
+
+bool MixEntry::matches(const P11Benchmark &benchmark) const
+{
+    if(benchmark.label() != label) {
+	return false;
+    }
+
+    if(test.empty()) {
+	return true;
+    }
+
+    return benchmark.name().find(test_names.at(test)) != std::string::npos;
+}
+
+
+MixProfile::MixProfile(std::string spec)
+{
+    boost::char_separator<char> sep(",");
+    boost::tokenizer<boost::char_separator<char>> toparse(spec, sep);
+
+    for(auto token: toparse) {
+	auto colon = token.rfind(':');
+
+	if(colon == std::string::npos) {
+	    throw MixProfileException("mix entries must be given as label[/test]:weight, got " + token);
+	}
+
+	MixEntry entry;
+	auto designation = token.substr(0, colon);
+	auto slash = designation.find('/');
+
+	entry.label = designation.substr(0, slash);
+	if(slash != std::string::npos) {
+	    entry.test = designation.substr(slash+1);
+	    if(test_names.find(entry.test) == test_names.end()) {
+		throw MixProfileException("unknown test case in mix entry " + token);
+	    }
+	}
+
+	char *end = nullptr;
+	auto weightstr = token.substr(colon+1);
+	entry.weight = strtod(weightstr.c_str(), &end);
+
+	if(entry.label.empty() || *end != '\0' || !(entry.weight > 0.0)) {
+	    throw MixProfileException("invalid mix entry " + token);
+	}
+
+	m_entries.push_back(entry);
+    }
+
+    if(m_entries.empty()) {
+	throw MixProfileException("mix is empty");
+    }
+}
@@ -0,0 +1,57 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// mixprofile.hpp: a class to describe a weighted mix of benchmarks, e.g. "hmac-256:60,rsa-2048/oaepunw:40"
+
+#if !defined(MIXPROFILE_H)
+#define MIXPROFILE_H
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "p11benchmark.hpp"
+
+struct MixProfileException : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+};
+
+// an entry of the mix designates a benchmark by its key label, and optionally by its test case name
+// (as given to --coverage), when several test cases use the same key, e.g. "rsa-2048/oaepunw".
+struct MixEntry {
+    std::string label;
+    std::string test;		// empty if not specified
+    double weight;
+
+    // matches(): tells if the benchmark is designated by this entry
+    bool matches(const P11Benchmark &benchmark) const;
+
+    std::string to_string() const { return test.empty() ? label : label + '/' + test; }
+};
+
+// a mix is given as a comma-separated list of label[/test]:weight entries
+class MixProfile
+{
+    std::vector<MixEntry> m_entries;
+
+public:
+    MixProfile(std::string spec);
+
+    inline const std::vector<MixEntry> &entries() const { return m_entries; }
+};
+
+#endif // MIXPROFILE_H
@@ -0,0 +1,71 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// mser.cpp: detection of the warm-up period of a series, using the MSER-5 rule
+
+#include <limits>
+#include "mser.hpp"
+
+
+// reference: K. P. White Jr., "An effective truncation heuristic for bias reduction in simulation output",
+// Simulation 69(6), 1997. The statistic is computed for every truncation point in a single pass,
+// from the end of the series, by accumulating the sum and the sum of squares of batch means.
+std::optional<size_t> mser5(const std::vector<boost::timer::nanosecond_type> &series)
+{
+    const size_t batches = series.size() / mser_batch;
+
+    if(batches < 10) {
+	return std::nullopt;
+    }
+
+    std::vector<double> means(batches, 0.0);
+    for(size_t j=0; j<batches; j++) {
+	for(size_t i=0; i<mser_batch; i++) {
+	    means[j] += static_cast<double>(series[j * mser_batch + i]);
+	}
+	means[j] /= mser_batch;
+    }
+
+    double sum = 0.0;
+    double sumsq = 0.0;
+    double lowest = std::numeric_limits<double>::max();
+    size_t truncation = 0;
+
+    for(size_t d=batches; d-- > 0; ) {
+	sum += means[d];
+	sumsq += means[d] * means[d];
+
+	const double m = batches - d;
+	if(m < 2) {
+	    continue;		// at least two batches must remain
+	}
+
+	// sum of squared deviations from the mean of the remaining batches, over (n-d)^2
+	const double mser = (sumsq - sum * sum / m) / (m * m);
+	if(mser <= lowest) {
+	    lowest = mser;
+	    truncation = d;
+	}
+    }
+
+    if(truncation > batches / 2) {
+	return std::nullopt;
+    }
+
+    return truncation * mser_batch;
+}
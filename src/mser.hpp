@@ -0,0 +1,43 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// mser.hpp: detection of the warm-up period of a series, using the MSER-5 rule
+
+#if !defined(MSER_H)
+#define MSER_H
+
+#include <vector>
+#include <optional>
+#include <cstddef>
+#include <boost/timer/timer.hpp>
+
+// The Marginal Standard Error Rule (MSER) truncates the first d observations of a series of n,
+// so as to minimize the standard error of the mean of the remaining ones:
+//
+//   MSER(d) = sum_{i>=d} (x_i - mean_d)^2 / (n-d)^2
+//
+// MSER-5 applies the rule to the means of consecutive batches of 5 observations, which smoothes the series.
+// The truncation point is trusted only when it falls in the first half of the series;
+// otherwise, the series is still drifting, or too short to tell.
+constexpr size_t mser_batch = 5;
+
+// mser5(): the number of observations to truncate (a multiple of the batch size),
+// or nothing if no truncation point can be trusted yet. At least 10 batches are needed.
+std::optional<size_t> mser5(const std::vector<boost::timer::nanosecond_type> &series);
+
+#endif // MSER_H
@@ -23,20 +23,19 @@
 #include <sstream>
 #include <mutex>
 #include <thread>
-#include <condition_variable>
+#include <chrono>
+#include <random>
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
 #include <boost/accumulators/statistics/count.hpp>
 #include <boost/accumulators/statistics/variance.hpp>
 #include "p11benchmark.hpp"
+#include "mser.hpp"
+#include "watchdog.hpp"
+#include "trace.hpp"
 #include "errorcodes.hpp"
 
-// thread sync objects
-extern std::mutex greenlight_mtx;
-extern std::condition_variable greenlight_cond;
-extern bool greenlight;
-
 static std::mutex display_mtx;
 
 
@@ -83,57 +82,646 @@ std::string P11Benchmark::build_threaded_label(std::optional<size_t> threadindex
 }
 
 
-benchmark_result_t P11Benchmark::execute(Session *session, const std::vector<uint8_t> &payload, size_t iterations, size_t skipiterations, std::optional<size_t> threadindex)
+// steady(): a time point of the steady clock, in nanoseconds, as traced
+static inline std::int64_t steady(std::chrono::steady_clock::time_point t)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+// since(): nanoseconds elapsed between epoch and now
+static inline nanosecond_type since(std::chrono::steady_clock::time_point epoch)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+
+// generator(): the random generator of the calling thread. Threads of the worker pool outlive test cases:
+// the generator is seeded once per thread, and its state carries over from one test case to the next.
+static std::mt19937 &generator()
+{
+    thread_local std::mt19937 rv { std::random_device{}() };
+    return rv;
+}
+
+
+// wait_until(): wait for a point in time on the steady clock.
+// we sleep for most of the wait, and spin for the last part, as the scheduler
+// may wake us up late, which would be accounted for as latency in open loop mode.
+static void wait_until(std::chrono::steady_clock::time_point deadline)
+{
+    constexpr auto spinning = std::chrono::microseconds(200);
+
+    if(deadline - std::chrono::steady_clock::now() > spinning) {
+	std::this_thread::sleep_until(deadline - spinning);
+    }
+
+    while(std::chrono::steady_clock::now() < deadline) {
+	std::this_thread::yield();
+    }
+}
+
+
+// setup(): look for the key object on the session, and prepare calls to crashtestdummy()
+bool P11Benchmark::setup(Session &session, const std::vector<uint8_t> &payload, std::optional<size_t> threadindex)
+{
+    auto label = build_threaded_label(threadindex); // build threaded label (if needed)
+
+    m_payload = payload;	// remember the payload
+
+    AttributeContainer search_template;
+    search_template.add_string( AttributeType::Label, label );
+    search_template.add_class( m_objectclass );
+
+    auto found_objs = Object::search<Object>( session, search_template.attributes() );
+
+    if( found_objs.size()==0 ) {
+	std::cerr << "Error: no object found for label '" << label << "'" << std::endl;
+	return false;
+    } else if( found_objs.size()>1 ) {
+	std::cerr << "Error: more than one object found for label '" << label << "'" << std::endl;
+	return false;
+    }
+
+    prepare(session, found_objs.front(), threadindex);
+    return true;
+}
+
+
+// setup_lanes(): a lane is a session, with the benchmark state prepared for it.
+// the first lane uses this object; other lanes use clones of it, kept in clones.
+bool P11Benchmark::setup_lanes(const std::vector<Session *> &sessions, const std::vector<uint8_t> &payload, std::optional<size_t> threadindex,
+			       lanes_t &lanes, std::vector<std::unique_ptr<P11Benchmark> > &clones)
+{
+    for(size_t k=0; k<sessions.size(); k++) {
+	P11Benchmark *state = this;
+
+	if(k>0) {
+	    clones.emplace_back(clone());
+	    state = clones.back().get();
+	}
+
+	if(!state->setup(*sessions[k], payload, threadindex)) {
+	    return false;
+	}
+	lanes.emplace_back(state, sessions[k]);
+    }
+
+    return true;
+}
+
+
+void P11Benchmark::trace_failure(Trace::Ring *ring, std::uint32_t tracecase, SessionHandle session, int rc, size_t retries)
+{
+    if(ring) {
+	m_t.stop();		// the timer was running when the call threw
+	auto end = steady(std::chrono::steady_clock::now());
+	ring->push({ end - static_cast<std::int64_t>(m_t.elapsed()), end, session, tracecase, static_cast<std::uint32_t>(rc), static_cast<std::uint32_t>(retries) });
+    }
+}
+
+
+void P11Benchmark::describe_calls()
+{
+    if(auto entry = Watchdog::current()) {
+	entry->describe(name() + " using " + label());
+    }
+}
+
+
+size_t P11Benchmark::route(const lanes_t &lanes, size_t i, Router *router, std::vector<size_t> &routed, std::mt19937 &generator)
+{
+    if(!router) {
+	return i % lanes.size();
+    }
+
+    auto slot = router->route(generator);
+    auto per_slot = lanes.size() / router->slots();
+    return slot * per_slot + routed[slot]++ % per_slot;
+}
+
+
+benchmark_result_t P11Benchmark::execute(const std::vector<Session *> &sessions, const std::vector<uint8_t> &payload, const ExecutionPlan &plan, std::optional<size_t> threadindex, Barrier &startline)
 {
-    int return_code = CKR_OK;
-    std::vector<nanosecond_type> records(iterations);
+    benchmark_result_t result;
+    bool released = false;	// tells if we went through the start line
+    auto &records = result.records;
+
+    lanes_t lanes;
+    std::vector<std::unique_ptr<P11Benchmark> > clones;
+
+    // with a histogram, recorded iterations are summarized instead
+    if(!plan.histogram) {
+	records.reserve(plan.duration_based() ? plan.miniterations : plan.iterations);
+	result.timestamps.reserve(records.capacity());
+    }
 
     try {
-	auto label = build_threaded_label(threadindex); // build threaded label (if needed)
+	if(setup_lanes(sessions, payload, threadindex, lanes, clones)) {
+	    // with a watchdog, calls (see Watchdog::Call) stuck for too long are reported with this description
+	    describe_calls();
+
+	    // with a trace, each recorded call is pushed to the ring of the thread
+	    auto ring = plan.traced ? Trace::current() : nullptr;
+	    auto tracecase = ring ? ring->testcase(name() + " using " + label(), payload.size()) : 0;
+
+	    std::chrono::steady_clock::time_point epoch;
+	    std::chrono::steady_clock::time_point deadline;
+
+	    // wait at the start line - all threads are starting together
+	    epoch = startline.arrive_and_wait();
+	    result.released = since(epoch); // the wake-up delay of each thread is reported as start line skew
+	    deadline = epoch + plan.duration; // deadline is shared by all threads
+	    released = true;
+
+	    // more(): tells if iteration i, happening at time t, is to be executed.
+	    // for duration-based runs, we carry on until the deadline, and until we have at least the minimum
+	    // number of iterations. Otherwise, the number of iterations is fixed.
+	    auto more = [&plan, &deadline] (size_t i, std::chrono::steady_clock::time_point t) -> bool {
+			    if(plan.duration_based()) {
+				return i < plan.miniterations || t < deadline;
+			    }
+			    return i < plan.iterations;
+			};
+
+	    // some threads may join later (e.g. when ramping up)
+	    if(plan.start_offset.count() > 0) {
+		wait_until(epoch + plan.start_offset);
+	    }
+
+	    // ok go now!
+
+	    auto &generator = ::generator();
+	    std::vector<size_t> routed(plan.router ? plan.router->slots() : 0, 0); // calls per slot, see route()
+
+	    std::vector<std::unique_ptr<Session> > reopened; // sessions opened in place of lost ones, see attempt()
+	    size_t retries = 0;		// retries of the last call, see attempt()
+	    nanosecond_type retried = 0;	// time spent in the last call before its last attempt, see attempt()
+
+	    // attempt(): call crashtestdummy() on a lane, and return its return code.
+	    // calls failing with a transient error are retried, as the retry policy says. When the session is gone,
+	    // a new one is opened, and the lane is prepared again on it.
+	    // unless errors are tolerated, a call failing for good ends the test case for the thread.
+	    auto attempt = [&plan, &generator, &reopened, &retries, &retried, &payload, &threadindex, &result] (lanes_t::value_type &lane) -> int {
+			       retries = 0;
+			       retried = 0;
+
+			       for(;;) {
+				   auto [state, session] = lane;
+				   try {
+				       state->crashtestdummy(*session);
+				       return CKR_OK;
+				   } catch (Botan::PKCS11::PKCS11_ReturnError &bexc) {
+				       auto rc = static_cast<int>(bexc.error_code());
+				       if(!plan.retry.retryable(rc) || retries == plan.retry.retries()) {
+					   if(!plan.tolerate_errors) {
+					       throw;
+					   }
+					   return rc;
+				       }
+
+				       wait_until(std::chrono::steady_clock::now() + plan.retry.backoff(retries, generator));
+
+				       if(RetryPolicy::reopens(rc)) {
+					   auto reopening = std::chrono::steady_clock::now();
+					   reopened.push_back(std::make_unique<Session>(session->slot(), false));
+					   lane.second = reopened.back().get();
+					   if(plan.password) {
+					       secure_string pwd( plan.password->data(), plan.password->data()+plan.password->length() );
+					       try {
+						   lane.second->login(UserType::User, pwd);
+					       } catch (Botan::PKCS11::PKCS11_ReturnError &err) {
+						   // login status is shared accross sessions: other sessions may still be logged in
+						   if(err.get_return_value() != ReturnValue::UserAlreadyLoggedIn) {
+						       throw;
+						   }
+					       }
+					   }
+					   if(auto entry = Watchdog::current()) {
+					       entry->reopened(lane.second->handle());
+					   }
+					   // the key is looked up again. Session keys are gone with the session that generated them
+					   if(!state->setup(*lane.second, payload, threadindex)) {
+					       throw ReopenException("session reopened, but the key could not be found on it"
+								     " (session keys do not survive their session, use --nogenerate)", rc);
+					   }
+					   result.reopened++;
+					   result.reopen_time += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - reopening).count();
+				       }
+				   }
+				   retries++;
+				   // the clock is read only once the call has failed: the timer of the call tells how long it took so far
+				   retried = lane.first->m_t.elapsed();
+			       }
+			   };
+
+	    // with a time series, recorded calls are counted per interval as they complete
+	    IntervalSampler sampler(result.series, plan.sample_interval);
+
+	    // call(): execute iteration i on the next lane, and record its latency, plus the delay it started with.
+	    // failed calls are recorded apart, with their return code.
+	    // with a histogram, the call is summarized instead, within the active window if it started once all threads
+	    // had started recording, and completed before any of them finished (see ActiveWindow).
+	    auto call = [&lanes, &attempt, &retries, &retried, &epoch, &plan, &routed, &generator, &records, &result, &sampler, ring, tracecase] (size_t i, nanosecond_type behind) {
+			    auto lane = route(lanes, i, plan.router, routed, generator);
+			    auto slot = plan.router ? lane / (lanes.size() / plan.router->slots()) : 0;
+			    Router::Call routing(plan.router, slot); // outstanding on its slot until complete, even if it throws
+			    auto state = lanes[lane].first;
+			    Watchdog::Call watched(lanes[lane].second->handle());
+			    const bool opened = !plan.window || plan.window->opened();
+			    state->m_t.start(); // start timer
+			    int rc = CKR_OK;
+			    try {
+				rc = attempt(lanes[lane]);
+			    } catch (Botan::PKCS11::PKCS11_ReturnError &bexc) {
+				// the call ending the test case for the thread is traced too
+				state->trace_failure(ring, tracecase, lanes[lane].second->handle(), bexc.error_code(), retries);
+				throw;
+			    } catch (ReopenException &rexc) {
+				state->trace_failure(ring, tracecase, lanes[lane].second->handle(), rexc.rc, retries);
+				throw;
+			    }
+			    state->m_t.stop(); // stop timer
+			    auto session = lanes[lane].second; // the session may have been reopened
+			    auto latency = state->m_t.elapsed();
+			    auto completed = since(epoch);
+			    if(plan.histogram) {
+				auto &summary = opened && !(plan.window && plan.window->closed()) ? result.in_window : result.outside;
+				if(rc != CKR_OK) {
+				    summary.errors.add(latency + behind);
+				    summary.error_codes[rc]++;
+				} else {
+				    summary.latency.record(latency + behind);
+				    summary.deadline_met += latency + behind - plan.overhead.count() <= plan.deadline.count() ? 1 : 0;
+				    if(plan.retry.enabled()) {
+					summary.retries.add(retries);
+					summary.retried += retries > 0 ? 1 : 0;
+					summary.retry_latency.add(retried);
+				    }
+				    if(plan.router) {
+					summary.slots.resize(plan.router->slots());
+					summary.slots[slot].record(latency + behind);
+				    }
+				}
+			    } else if(rc != CKR_OK) {
+				result.errors.push_back(latency + behind);
+				result.error_timestamps.push_back(completed);
+				result.error_codes.push_back(rc);
+			    } else {
+				result.timestamps.push_back(completed);
+				records.push_back(latency + behind);
+				if(plan.retry.enabled()) {
+				    result.retries.push_back(retries);
+				    result.retried.push_back(retried);
+				}
+				if(plan.router) {
+				    result.slots.push_back(slot);
+				}
+			    }
+			    sampler.sample(completed, latency + behind, rc == CKR_OK);
+			    if(ring) {
+				// the call started its latency before it completed
+				auto end = steady(epoch) + completed;
+				ring->push({ end - latency, end, session->handle(), tracecase, static_cast<std::uint32_t>(rc), static_cast<std::uint32_t>(retries) });
+			    }
+			    state->cleanup(*session); // cleanup any created object (e.g. unwrapped or derived keys)
+			    routing.complete(latency);
+			};
+
+	    // first run iterations that are skipped, i.e. not taken into account for stats
+	    for (size_t i=0; i<plan.skipiterations && !plan.auto_skip(); i++) {
+		auto &lane = lanes[i % lanes.size()];
+		Watchdog::Call watched(lane.second->handle());
+		attempt(lane);
+		lane.first->cleanup(*lane.second); // cleanup any created object (e.g. unwrapped or derived keys)
+	    }
+
+	    // with automatic skip, warm-up iterations are timed, and MSER-5 is applied to the series
+	    // every few batches, until it finds where the steady state begins, or the maximum is reached.
+	    for (size_t i=0; i<plan.autoskip && !result.steady; i++) {
+		auto &lane = lanes[i % lanes.size()];
+		auto state = lane.first;
+		Watchdog::Call watched(lane.second->handle());
+		state->m_t.start(); // start timer
+		auto rc = attempt(lane);
+		state->m_t.stop(); // stop timer
+		state->cleanup(*lane.second); // cleanup any created object (e.g. unwrapped or derived keys)
+		if(rc != CKR_OK) {
+		    continue;	// a failed call tells nothing about the warm-up
+		}
+		result.warmup.push_back(state->m_t.elapsed());
+
+		if(result.warmup.size() % (5 * mser_batch) == 0) {
+		    auto truncation = mser5(result.warmup);
+		    result.steady = truncation.has_value();
+		    result.truncation = truncation.value_or(result.warmup.size());
+		}
+	    }
+
+	    if(plan.auto_skip() && !result.steady) {
+		result.truncation = result.warmup.size(); // no steady state detected: all of it was warm-up
+	    }
+
+	    cpu_usage_t cpu_start;
+	    if(plan.cpu_usage) {
+		cpu_start = sample_cpu_usage();
+	    }
+
+	    auto span_start = std::chrono::steady_clock::now();
+	    result.started = since(epoch);
+	    // intervals of the time series start when the first thread of the run started recording
+	    sampler.start(plan.window ? plan.window->start(epoch, result.started) : result.started);
+
+	    size_t i = 0;		// number of recorded iterations executed, successful or not
+	    if(plan.open_loop()) {
+		// open loop: iterations are scheduled on a fixed timeline, regardless of how long
+		// the previous call took. Latency is measured from the planned start time, so
+		// that any stall of the token is accounted for (i.e. no coordinated omission).
+		const std::chrono::duration<double, std::nano> interval { 1e9 / plan.rate };
+		const auto timeline = span_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval * plan.phase);
+
+		for ( ; ; i++) {
+		    auto planned = timeline + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval * static_cast<double>(i));
+		    if(!more(i, planned)) {
+			break;
+		    }
+		    wait_until(planned);
+		    // if we are behind schedule, the delay is part of the latency
+		    auto behind = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - planned).count();
+		    call(i, behind);
+		}
+
+		// the schedule covers a whole number of intervals, one per call; if the token kept up,
+		// we wait for the end of the last interval, so the achieved rate is not overestimated.
+		wait_until(timeline + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval * static_cast<double>(i)));
+		span_start = timeline;
+	    } else {
+		for ( ; more(i, std::chrono::steady_clock::now()); i++) {
+		    call(i, 0);
+		    // think time: the thread waits before its next call, outside of the timed region
+		    if(plan.thinktime.enabled()) {
+			wait_until(std::chrono::steady_clock::now() + plan.thinktime.draw(generator));
+		    }
+		}
+	    }
+
+	    result.finished = since(epoch);
+	    if(plan.window) {
+		plan.window->finish();
+	    }
+	    result.span = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - span_start).count();
+
+	    if(plan.cpu_usage) {
+		result.cpu = sample_cpu_usage() - cpu_start;
+		result.cpu.calls = i;
+	    }
+	}
+    } catch (Botan::PKCS11::PKCS11_ReturnError &bexc) {
+	{
+	    std::lock_guard<std::mutex> lg{display_mtx};
+	    std::cerr << "ERROR:: " << bexc.what()
+		      << " (" << errorcode(bexc.error_code()) << ")" << std::endl;
+	}
+	result.errcode = bexc.error_code();
+	// we print the exception, and move on
+    } catch (ReopenException &rexc) {
+	{
+	    std::lock_guard<std::mutex> lg{display_mtx};
+	    std::cerr << "ERROR:: " << rexc.what()
+		      << " (" << errorcode(rexc.rc) << ")" << std::endl;
+	}
+	result.errcode = rexc.rc;
+	// the lost call ends the test case for the thread, as any unrecoverable error
+    } catch (...) {
+	{
+	    std::lock_guard<std::mutex> lg{display_mtx};
+	    std::cerr << "ERROR: caught an unmanaged exception" << std::endl;
+	}
+	if(!released) {
+	    startline.arrive();	// don't leave other threads waiting
+	}
+	// bailing out
+	throw;
+    }
+
+    if(!released) {
+	startline.arrive();	// we failed before the start line, don't leave other threads waiting
+    }
+
+    return result;
+}
+
 
-	m_payload = payload;	// remember the payload
+benchmark_result_t P11Benchmark::serve(const std::vector<Session *> &sessions, const std::vector<uint8_t> &payload, const ExecutionPlan &plan, std::optional<size_t> threadindex, Barrier &startline, RequestQueue &requests)
+{
+    benchmark_result_t result;
+    bool released = false;	// tells if we went through the start line
+    lanes_t lanes;
+    std::vector<std::unique_ptr<P11Benchmark> > clones;
+    std::optional<Request> request;
 
-	AttributeContainer search_template;
-	search_template.add_string( AttributeType::Label, label );
-	search_template.add_class( m_objectclass );
+    try {
+	if(setup_lanes(sessions, payload, threadindex, lanes, clones)) {
+	    describe_calls();
 
-	auto found_objs = Object::search<Object>( *session, search_template.attributes() );
+	    // see execute()
+	    auto ring = plan.traced ? Trace::current() : nullptr;
+	    auto tracecase = ring ? ring->testcase(name() + " using " + label(), payload.size()) : 0;
 
-	if( found_objs.size()==0 ) {
-	    std::cerr << "Error: no object found for label '" << label << "'" << std::endl;
-	} else	if( found_objs.size()>1 ) {
-	    std::cerr << "Error: more than one object found for label '" << label << "'" << std::endl;
-	} else {
-	    for (auto &obj: found_objs) {
+	    // skipped iterations are run before the start line, not to delay the first requests
+	    for (size_t i=0; i<plan.skipiterations; i++) {
+		auto [state, session] = lanes[i % lanes.size()];
+		Watchdog::Call watched(session->handle());
+		state->crashtestdummy(*session);
+		state->cleanup(*session); // cleanup any created object (e.g. unwrapped or derived keys)
+	    }
 
-		prepare(*session, obj, threadindex);
+	    // wait at the start line - all carriers are starting together
+	    auto epoch = startline.arrive_and_wait();
+	    result.released = since(epoch);
+	    released = true;
 
-		boost::timer::cpu_times started;
+	    auto span_start = std::chrono::steady_clock::now();
+	    result.started = since(epoch);
+	    IntervalSampler sampler(result.series, plan.sample_interval); // see execute()
+	    sampler.start(plan.window ? plan.window->start(epoch, result.started) : result.started);
 
-		started.clear();
+	    auto &generator = ::generator();
+	    std::vector<size_t> routed(plan.router ? plan.router->slots() : 0, 0); // calls per slot, see route()
 
-		// wait for green light - all threads are starting together
-		{
-		    std::unique_lock<std::mutex> greenlight_lck(greenlight_mtx);
-		    greenlight_cond.wait(greenlight_lck,[]{ return greenlight; });
+	    for (size_t i=0; (request = requests.pop()); i++) {
+		auto lane = route(lanes, i, plan.router, routed, generator);
+		auto slot = plan.router ? lane / (lanes.size() / plan.router->slots()) : 0;
+		Router::Call routing(plan.router, slot); // see execute()
+		auto [state, session] = lanes[lane];
+		auto started = std::chrono::steady_clock::now();
+		// queueing delay: time spent by the request, waiting for a carrier
+		result.queueing.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(started - request->submitted).count());
+		Watchdog::Call watched(session->handle());
+		state->m_t.start(); // start timer
+		try {
+		    state->crashtestdummy(*session);
+		} catch (Botan::PKCS11::PKCS11_ReturnError &bexc) {
+		    state->trace_failure(ring, tracecase, session->handle(), bexc.error_code(), 0); // see execute()
+		    throw;
 		}
+		state->m_t.stop(); // stop timer
+		result.timestamps.push_back(since(epoch));
+		state->cleanup(*session); // cleanup any created object (e.g. unwrapped or derived keys)
+		// service time: time spent by the token to process the request
+		result.records.push_back(state->m_t.elapsed());
+		sampler.sample(result.timestamps.back(), result.records.back(), true);
+		if(ring) {
+		    auto end = steady(epoch) + result.timestamps.back();
+		    ring->push({ end - result.records.back(), end, session->handle(), tracecase, CKR_OK, 0 });
+		}
+		routing.complete(result.records.back());
+		if(plan.router) {
+		    result.slots.push_back(slot);
+		}
+		requests.complete(*request);
+		request.reset();
+	    }
+
+	    result.finished = since(epoch);
+	    if(plan.window) {
+		plan.window->finish();
+	    }
+	    result.span = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - span_start).count();
+	}
+    } catch (Botan::PKCS11::PKCS11_ReturnError &bexc) {
+	{
+	    std::lock_guard<std::mutex> lg{display_mtx};
+	    std::cerr << "ERROR:: " << bexc.what()
+		      << " (" << errorcode(bexc.error_code()) << ")" << std::endl;
+	}
+	result.errcode = bexc.error_code();
+	if(request) {
+	    requests.abort();	// stop the run, other carriers will drain the queue
+	}
+	// we print the exception, and move on
+    } catch (...) {
+	{
+	    std::lock_guard<std::mutex> lg{display_mtx};
+	    std::cerr << "ERROR: caught an unmanaged exception" << std::endl;
+	}
+	if(!released) {
+	    startline.arrive();	// don't leave other threads waiting
+	}
+	if(request) {
+	    requests.abort();
+	}
+	// bailing out
+	throw;
+    }
+
+    if(!released) {
+	startline.arrive();	// we failed before the start line, don't leave other threads waiting
+    }
+
+    return result;
+}
+
+
+benchmark_result_t P11Benchmark::execute_mix(const std::vector<P11Benchmark *> &benchmarks, const std::vector<double> &weights, const std::vector<Session *> &sessions, const std::vector<uint8_t> &payload, const ExecutionPlan &plan, std::optional<size_t> threadindex, Barrier &startline)
+{
+    benchmark_result_t result;
+    bool released = false;	// tells if we went through the start line
+    std::vector<lanes_t> lanes(benchmarks.size()); // lanes of each benchmark
+    std::vector<std::unique_ptr<P11Benchmark> > clones;
+    std::vector<size_t> calls(benchmarks.size(), 0); // number of calls of each benchmark, to rotate over lanes
+    auto &generator = ::generator();
+    std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+    result.records.reserve(plan.duration_based() ? plan.miniterations : plan.iterations);
+    result.operations.reserve(result.records.capacity());
+    result.timestamps.reserve(result.records.capacity());
+
+    try {
+	bool ready = true;
+
+	for(size_t b=0; ready && b<benchmarks.size(); b++) {
+	    clones.emplace_back(benchmarks[b]->clone());
+	    auto state = clones.back().get();
+	    ready = state->setup_lanes(sessions, payload, threadindex, lanes[b], clones);
+	}
+
+	if(ready) {
+	    if(auto entry = Watchdog::current()) {
+		entry->describe("mixed workload");
+	    }
+
+	    // see execute()
+	    auto ring = plan.traced ? Trace::current() : nullptr;
+	    std::vector<std::uint32_t> tracecases;
+	    for(size_t b=0; ring && b<benchmarks.size(); b++) {
+		tracecases.push_back(ring->testcase(benchmarks[b]->name() + " using " + benchmarks[b]->label(), payload.size()));
+	    }
+
+	    // wait at the start line - all threads are starting together
+	    auto epoch = startline.arrive_and_wait();
+	    result.released = since(epoch);
+	    auto deadline = epoch + plan.duration; // deadline is shared by all threads
+	    released = true;
 
-		// ok go now!
+	    // see execute()
+	    auto more = [&plan, &deadline] (size_t i, std::chrono::steady_clock::time_point t) -> bool {
+			    if(plan.duration_based()) {
+				return i < plan.miniterations || t < deadline;
+			    }
+			    return i < plan.iterations;
+			};
 
-		// first run iterations that are skipped, i.e. not taken into account for stats
-		for (size_t i=0; i<skipiterations; i++) {
-		    crashtestdummy(*session);
-		    cleanup(*session); // cleanup any created object (e.g. unwrapped or derived keys)
+	    // next(): pick a benchmark, and its next lane
+	    auto next = [&lanes, &calls, &generator, &pick] () {
+			    auto b = pick(generator);
+			    auto lane = lanes[b][calls[b]++ % lanes[b].size()];
+			    return std::make_tuple(b, lane.first, lane.second);
+			};
+
+	    // first run iterations that are skipped, i.e. not taken into account for stats
+	    for (size_t i=0; i<plan.skipiterations; i++) {
+		auto [b, state, session] = next();
+		Watchdog::Call watched(session->handle());
+		state->crashtestdummy(*session);
+		state->cleanup(*session); // cleanup any created object (e.g. unwrapped or derived keys)
+	    }
+
+	    auto span_start = std::chrono::steady_clock::now();
+	    result.started = since(epoch);
+	    IntervalSampler sampler(result.series, plan.sample_interval); // see execute()
+	    sampler.start(plan.window ? plan.window->start(epoch, result.started) : result.started);
+
+	    for (size_t i=0; more(i, std::chrono::steady_clock::now()); i++) {
+		auto [b, state, session] = next();
+		Watchdog::Call watched(session->handle());
+		state->m_t.start(); // start timer
+		try {
+		    state->crashtestdummy(*session);
+		} catch (Botan::PKCS11::PKCS11_ReturnError &bexc) {
+		    state->trace_failure(ring, ring ? tracecases[b] : 0, session->handle(), bexc.error_code(), 0); // see execute()
+		    throw;
+		}
+		state->m_t.stop(); // stop timer
+		result.timestamps.push_back(since(epoch));
+		state->cleanup(*session); // cleanup any created object (e.g. unwrapped or derived keys)
+		result.records.push_back(state->m_t.elapsed());
+		result.operations.push_back(b);
+		sampler.sample(result.timestamps.back(), result.records.back(), true);
+		if(ring) {
+		    auto end = steady(epoch) + result.timestamps.back();
+		    ring->push({ end - result.records.back(), end, session->handle(), tracecases[b], CKR_OK, 0 });
 		}
-		for (size_t i=0; i<iterations; i++) {
-		    m_t.start(); // start timer
-		    started.wall = m_t.elapsed().wall; // remember wall clock
-		    crashtestdummy(*session);
-		    m_t.stop(); // stop timer
-		    cleanup(*session); // cleanup any created object (e.g. unwrapped or derived keys)
-		    records.at(i) = m_t.elapsed().wall - started.wall;
+		if(plan.thinktime.enabled()) {
+		    wait_until(std::chrono::steady_clock::now() + plan.thinktime.draw(generator));
 		}
 	    }
+
+	    result.finished = since(epoch);
+	    if(plan.window) {
+		plan.window->finish();
+	    }
+
+	    result.span = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - span_start).count();
 	}
     } catch (Botan::PKCS11::PKCS11_ReturnError &bexc) {
 	{
@@ -141,16 +729,23 @@ benchmark_result_t P11Benchmark::execute(Session *session, const std::vector<uin
 	    std::cerr << "ERROR:: " << bexc.what()
 		      << " (" << errorcode(bexc.error_code()) << ")" << std::endl;
 	}
-	return_code = bexc.error_code();
+	result.errcode = bexc.error_code();
 	// we print the exception, and move on
     } catch (...) {
 	{
 	    std::lock_guard<std::mutex> lg{display_mtx};
 	    std::cerr << "ERROR: caught an unmanaged exception" << std::endl;
 	}
+	if(!released) {
+	    startline.arrive();	// don't leave other threads waiting
+	}
 	// bailing out
 	throw;
     }
 
-    return std::make_pair( std::move(records), return_code );
+    if(!released) {
+	startline.arrive();	// we failed before the start line, don't leave other threads waiting
+    }
+
+    return result;
 }
@@ -20,8 +20,12 @@
 #define P11BENCHMARK_H
 
 #include <forward_list>
+#include <vector>
+#include <memory>
+#include <chrono>
 #include <optional>
 #include <utility>
+#include <random>
 #include <botan/auto_rng.h>
 #include <botan/p11_types.h>
 #include <botan/p11_object.h>
@@ -30,12 +34,94 @@
 #include <botan/pubkey.h>
 #include <boost/timer/timer.hpp>
 #include "implementation.hpp"
+#include "barrier.hpp"
+#include "requestqueue.hpp"
+#include "thinktime.hpp"
+#include "retrypolicy.hpp"
+#include "router.hpp"
+#include "calltimer.hpp"
+#include "cpuusage.hpp"
+#include "histogram.hpp"
+#include "callsummary.hpp"
+#include "timeseries.hpp"
+#include "activewindow.hpp"
+#include "trace.hpp"
 #include "../config.h"
 
 
 using namespace Botan::PKCS11;
 using namespace boost::timer;
-using benchmark_result_t = std::pair<std::vector<nanosecond_type>,int>;
+
+// ExecutionPlan: how a thread drives the iterations of a test case
+struct ExecutionPlan {
+    size_t iterations;		// number of iterations recorded for statistics
+    size_t skipiterations;	// number of iterations executed before recording
+    size_t autoskip { 0 };	// automatic skip: maximum number of warm-up iterations, run until the steady state is detected.
+				// 0 means skipiterations are executed
+    double rate { 0.0 };	// open loop only: offered rate in Tnx/s, for all threads (Executor) or for one thread (execute()).
+				// 0 means closed loop
+    double phase { 0.0 };	// open loop only: offset of the thread timeline, as a fraction of the interval
+    std::chrono::nanoseconds duration { 0 }; // duration-based runs: time after which threads stop recording.
+					     // 0 means the number of iterations is fixed
+    size_t miniterations { 0 };	// duration-based runs only: minimum number of iterations recorded per thread
+    std::chrono::nanoseconds start_offset { 0 }; // delay after start before the thread becomes active
+    ThinkTime thinktime;	// closed loop only: time the thread waits between two calls
+    Router *router { nullptr };	// multi-slot only: chooses the slot of each call, shared by all threads
+    ActiveWindow *window { nullptr }; // shared by all threads of the run: tells the active window, and aligns time series. Set by the executor
+    double target_relerr { 0.0 };	// adaptive runs: relative error (k=2) on the targeted measure, at which to stop.
+				// 0 means the number of iterations is fixed
+    double target_percentile { 0.0 }; // adaptive runs only: targeted percentile (0<p<1). 0 means the average latency
+    size_t maxiterations { 0 };	// adaptive runs only: maximum number of iterations recorded per thread
+    std::chrono::nanoseconds deadline { 0 }; // latency within which an operation counts towards goodput. 0 means no deadline
+    bool tolerate_errors { false };	// when set, calls returning an error are counted by return code, and the thread carries on
+    RetryPolicy retry;		// how calls failing with a transient error are retried
+    std::optional<std::string> password; // with a retry policy: to log in sessions reopened in place of lost ones. Set by the executor
+    bool cpu_usage { false };	// when set, the CPU usage of the thread is sampled around recorded iterations
+    bool histogram { false };	// when set, recorded iterations are summarized as they complete, their latency counted in a histogram,
+				// instead of being kept one by one (see call_summary_t)
+    std::chrono::nanoseconds sample_interval { 0 }; // time series: length of intervals over which calls are sampled. 0 means none
+    bool subtract_overhead { false }; // when set, the harness overhead (see Executor::calibrate()) is subtracted from latency
+    std::chrono::nanoseconds overhead { 0 }; // with subtract_overhead: the overhead, subtracted from latency before it is
+					     // compared to the deadline. Set by the executor
+    bool traced { true };	// when unset, calls are not written to the trace, if any (e.g. when calibrating)
+
+    inline bool open_loop() const { return rate > 0.0; }
+    inline bool duration_based() const { return duration.count() > 0; }
+    inline bool auto_skip() const { return autoskip > 0; }
+    // adaptive(): iterations are run in chunks, until the targeted relative error is reached
+    inline bool adaptive() const { return target_relerr > 0.0; }
+    // paced(): threads are idle between calls, so TPS cannot be inferred from latency
+    inline bool paced() const { return open_loop() || thinktime.enabled(); }
+};
+
+// benchmark_result_t: what a thread returns after execution.
+// with a histogram (see ExecutionPlan::histogram), recorded iterations are summarized, and vectors about them are left empty
+struct benchmark_result_t {
+    std::vector<nanosecond_type> records; // latency of each recorded iteration (service time, when serving requests)
+    std::vector<nanosecond_type> queueing; // when serving requests: time each request waited for a carrier
+    std::vector<size_t> operations;	  // in a mix: which benchmark was executed, for each recorded iteration
+    std::vector<size_t> slots;		  // with a router: which slot was used, for each recorded iteration
+    std::vector<nanosecond_type> timestamps; // completion time of each recorded iteration, since start
+    nanosecond_type span { 0 };		  // wall time taken by recorded iterations
+    nanosecond_type released { 0 };	  // when the thread left the start line, since start
+    nanosecond_type started { 0 };	  // when the thread started recording iterations, since start
+    nanosecond_type finished { 0 };	  // when the thread completed its last recorded iteration, since start
+    std::vector<nanosecond_type> warmup;  // automatic skip: latency of each iteration executed before recording
+    size_t truncation { 0 };		  // automatic skip: number of warm-up iterations detected by MSER-5
+    bool steady { false };		  // automatic skip: tells if the steady state was detected, before reaching the maximum
+    std::vector<nanosecond_type> errors;  // when errors are tolerated: latency of each failed call, recorded apart
+    std::vector<nanosecond_type> error_timestamps; // when errors are tolerated: completion time of each failed call, since start
+    std::vector<int> error_codes;	  // when errors are tolerated: return code of each failed call
+    std::vector<size_t> retries;	  // with a retry policy: number of retries of each recorded iteration
+    std::vector<nanosecond_type> retried; // with a retry policy: time spent before the last attempt of each recorded iteration
+    size_t reopened { 0 };		  // with a retry policy: number of sessions reopened
+    nanosecond_type reopen_time { 0 };	  // with a retry policy: time spent reopening sessions and preparing them again
+    cpu_usage_t cpu;			  // CPU usage of the thread while recording iterations, when sampled
+    call_summary_t in_window;		  // with a histogram: recorded iterations executed within the active window, summarized
+    call_summary_t outside;		  // with a histogram: other recorded iterations, summarized
+    sampled_series_t series;		  // time series: calls of the thread, sampled per interval while it ran
+    int errcode { CKR_OK };		  // last return code
+};
 
 class P11Benchmark
 {
@@ -43,7 +129,27 @@ class P11Benchmark
     std::string m_label;
     ObjectClass m_objectclass;
     Implementation m_implementation;
-    boost::timer::cpu_timer m_t; // the timer can be stopped and resumed by crash test dummy
+    CallTimer m_t;		 // the timer can be stopped and resumed by crash test dummy
+
+    // a lane is a session, with a benchmark state prepared for it
+    using lanes_t = std::vector<std::pair<P11Benchmark *, Session *> >;
+
+    // route(): choose the lane of iteration i. Without router, lanes are used round-robin.
+    // Otherwise, lanes are grouped by slot: the router picks the slot, and lanes of that slot are used round-robin.
+    static size_t route(const lanes_t &lanes, size_t i, Router *router, std::vector<size_t> &routed, std::mt19937 &generator);
+
+    // setup(): look for the key object on the session, and prepare calls to crashtestdummy()
+    virtual bool setup(Session &session, const std::vector<uint8_t> &payload, std::optional<size_t> threadindex);
+
+    // setup_lanes(): prepare one lane per session
+    bool setup_lanes(const std::vector<Session *> &sessions, const std::vector<uint8_t> &payload, std::optional<size_t> threadindex,
+		     lanes_t &lanes, std::vector<std::unique_ptr<P11Benchmark> > &clones);
+
+    // describe_calls(): when the thread is watched, tell the watchdog what it executes
+    void describe_calls();
+
+    // trace_failure(): when the thread is traced, push the call in progress, that failed with rc and ends the test case
+    void trace_failure(Trace::Ring *ring, std::uint32_t tracecase, SessionHandle session, int rc, size_t retries);
 
 protected:
     std::vector<uint8_t> m_payload;
@@ -90,7 +196,17 @@ public:
 
     virtual std::string features() const;
 
-    benchmark_result_t execute(Session* session, const std::vector<uint8_t> &payload, size_t iterations, size_t skipiterations, std::optional<size_t> threadindex);
+    // execute(): run the test case. all threads wait at the start line before executing iterations.
+    // iterations are spread round-robin over sessions, each session having its own prepared state.
+    benchmark_result_t execute(const std::vector<Session *> &sessions, const std::vector<uint8_t> &payload, const ExecutionPlan &plan, std::optional<size_t> threadindex, Barrier &startline);
+
+    // serve(): act as a carrier thread, serving requests issued by logical clients, until the run is over.
+    // the service time and queueing delay of each request are recorded.
+    benchmark_result_t serve(const std::vector<Session *> &sessions, const std::vector<uint8_t> &payload, const ExecutionPlan &plan, std::optional<size_t> threadindex, Barrier &startline, RequestQueue &requests);
+
+    // execute_mix(): run a weighted mix of benchmarks. each iteration picks a benchmark at random, according to weights.
+    // benchmarks are not modified, each thread works on its own clones.
+    static benchmark_result_t execute_mix(const std::vector<P11Benchmark *> &benchmarks, const std::vector<double> &weights, const std::vector<Session *> &sessions, const std::vector<uint8_t> &payload, const ExecutionPlan &plan, std::optional<size_t> threadindex, Barrier &startline);
 
 };
 
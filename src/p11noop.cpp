@@ -0,0 +1,49 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// p11noop.cpp: an empty operation, to measure the overhead of the benchmark loop
+
+#include "p11noop.hpp"
+
+
+P11NoopBenchmark::P11NoopBenchmark() :
+    P11Benchmark( "No operation (harness calibration)", "noop", ObjectClass::SecretKey ) { }
+
+
+P11NoopBenchmark::P11NoopBenchmark(const P11NoopBenchmark &other) :
+    P11Benchmark(other) { }
+
+
+inline P11NoopBenchmark *P11NoopBenchmark::clone() const {
+    return new P11NoopBenchmark{*this};
+}
+
+// setup(): there is no key to look for
+bool P11NoopBenchmark::setup(Session &session, const std::vector<uint8_t> &payload, std::optional<size_t> threadindex)
+{
+    m_payload = payload;
+    return true;
+}
+
+void P11NoopBenchmark::prepare(Session &session, Object &obj, std::optional<size_t> threadindex)
+{
+}
+
+void P11NoopBenchmark::crashtestdummy(Session &session)
+{
+}
@@ -0,0 +1,43 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// p11noop.hpp: an empty operation, to measure the overhead of the benchmark loop
+
+#if !defined P11NOOP_HPP
+#define P11NOOP_HPP
+
+#include "p11benchmark.hpp"
+
+
+// P11NoopBenchmark makes no PKCS#11 call, and needs no key: executed by the same loop as other benchmarks,
+// it measures what is timed around crashtestdummy(), i.e. the timer itself and the dispatch of the call.
+class P11NoopBenchmark : public P11Benchmark
+{
+    virtual bool setup(Session &session, const std::vector<uint8_t> &payload, std::optional<size_t> threadindex) override;
+    virtual void prepare(Session &session, Object &obj, std::optional<size_t> threadindex) override;
+    virtual void crashtestdummy(Session &session) override;
+    virtual P11NoopBenchmark *clone() const override;
+
+public:
+
+    P11NoopBenchmark();
+    P11NoopBenchmark(const P11NoopBenchmark & other);
+
+};
+
+#endif // P11NOOP_HPP
@@ -28,8 +28,14 @@
 #include <fstream>
 #include <forward_list>
 #include <thread>
+#include <optional>
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <stdexcept>
 #include <sysexits.h>		// BSD exit codes
+#include <unistd.h>
+#include <fcntl.h>
 
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/range/adaptor/map.hpp>
@@ -49,6 +55,20 @@
 #include "testcoverage.hpp"
 #include "vectorcoverage.hpp"
 #include "keysizecoverage.hpp"
+#include "ratecoverage.hpp"
+#include "duration.hpp"
+#include "thinktime.hpp"
+#include "retrypolicy.hpp"
+#include "calltimer.hpp"
+#include "rampprofile.hpp"
+#include "threadcoverage.hpp"
+#include "mixprofile.hpp"
+#include "placement.hpp"
+#include "slotcoverage.hpp"
+#include "router.hpp"
+#include "processgroup.hpp"
+#include "watchdog.hpp"
+#include "trace.hpp"
 #include "timeprecision.hpp"
 #include "keygenerator.hpp"
 #include "executor.hpp"
@@ -101,8 +121,22 @@ int main(int argc, char **argv)
     int rv = EXIT_SUCCESS;
     pt::ptree results;
     int argslot = -1;
-    int argiter, argskipiter;
+    int argiter;
+    int argskipiter = 0;
+    int argautoskip = 0;
+    int argminiter = 0;
+    int argmaxiter = 0;
+    std::chrono::nanoseconds argduration { 0 };
+    std::chrono::nanoseconds argdeadline { 0 };
+    std::chrono::nanoseconds argwatchdog { 0 };
+    std::chrono::nanoseconds argtimeseries { 0 };
     int argnthreads;
+    int argsessions;
+    int argprocesses;
+    int argabrounds;
+    int argclients = 0;
+    int arginflight = 1;
+    double argrate = 0.0;
     bool json = false;
     std::fstream jsonout;
     bool generate_session_keys = true;
@@ -127,14 +161,117 @@ int main(int argc, char **argv)
 	("slot,s", po::value<int>(&argslot),
 	 "slot index to use\n"
 	 "overrides PKCS11SLOT environment variable")
+	("slots", po::value< std::string >(),
+	 "comma-separated list of slot indices to spread calls accross, e.g. 0,1,2,3\n"
+	 "each thread opens its sessions on every slot; overrides -s")
+	("routing", po::value< std::string >()->default_value("round-robin"),
+	 "with --slots, policy to choose the slot of each call:\n"
+	 "round-robin, least-outstanding, power-of-two or latency-weighted")
+	("library-b", po::value< std::string >(),
+	 "A/B comparison: PKCS#11 library path for B (defaults to the library of A)\n"
+	 "each benchmark is run alternately on A and B, and measures are compared")
+	("slot-b", po::value<int>(),
+	 "A/B comparison: slot index for B (defaults to the slot of A)")
+	("password-b", po::value< std::string >(),
+	 "A/B comparison: password for token in slot B (defaults to the password of A)")
+	("ab-rounds", po::value<int>(&argabrounds)->default_value(2),
+	 "A/B comparison: number of rounds, each running A and B once\n"
+	 "A runs first in odd rounds, B in even rounds (ABBA order), to cancel drift")
 	("password,p", po::value< std::string >(),
 	 "password for token in slot\n"
 	 "overrides PKCS11PASSWORD environment variable")
 	("threads,t", po::value<int>(&argnthreads)->default_value(1), "number of concurrent threads")
+	("processes", po::value<int>(&argprocesses)->default_value(1),
+	 "number of processes, each running -t threads\n"
+	 "each process initializes the PKCS#11 library, logs in and prepares its own keys; results are aggregated")
+	("sessions-per-thread", po::value<int>(&argsessions)->default_value(1),
+	 "number of sessions opened by each thread\n"
+	 "each session has its own prepared state, and iterations are spread round-robin accross sessions")
 	("iterations,i", po::value<int>(&argiter)->default_value(200), "number of iterations")
-	("skip", po::value<int>(&argskipiter)->default_value(0),
+	("skip", po::value< std::string >()->default_value("0"),
 	 "number of iterations to skip before recording for statistics\n"
-	 "(in addition to iterations)")
+	 "(in addition to iterations)\n"
+	 "auto[:max] runs warm-up iterations until MSER-5 detects the steady state, up to max (default 1000) per thread")
+	("duration", po::value< std::string >(),
+	 "run each test case for a given duration (e.g. 30s, 500ms, 2m), instead of a fixed number of iterations\n"
+	 "all threads stop recording at the same deadline")
+	("deadline", po::value< std::string >(),
+	 "latency within which an operation meets its SLA, e.g. 20ms\n"
+	 "the share of calls within the deadline and the goodput (TPS of those calls) are reported")
+	("watchdog", po::value< std::string >(),
+	 "hard limit on the duration of a single call, e.g. 10s\n"
+	 "stuck calls are reported with their thread, session and benchmark, and the run is aborted")
+	("trace", po::value< std::string >(),
+	 "write a binary trace of every recorded call to the given file, e.g. run.p11t\n"
+	 "see p11tracedump to convert it to CSV. With several processes, each writes its own, suffixed by its rank")
+	("tolerate-errors", "carry on after a call returns an error, rather than ending the test case\n"
+	 "failed calls are counted per return code, and their latency is recorded apart")
+	("retry", po::value< std::string >(),
+	 "retry calls failing with a transient error, given as fixed:<delay>[:<retries>],\n"
+	 "exp:<delay>[:<retries>] (exponential backoff with jitter) or reopen[:<retries>], e.g. exp:1ms:5\n"
+	 "lost sessions are reopened; retries and the latency they add are reported")
+	("retry-on", po::value< std::string >()->default_value("CKR_DEVICE_ERROR,CKR_DEVICE_MEMORY,CKR_SESSION_HANDLE_INVALID,CKR_SESSION_CLOSED"),
+	 "with --retry, comma-separated list of return codes for which calls are retried")
+	("min-iterations", po::value<int>(&argminiter)->default_value(0),
+	 "with --duration, minimum number of iterations recorded per thread, even past the deadline")
+	("target-relerr", po::value< std::string >(),
+	 "adaptive runs: relative error on latency at which to stop, e.g. 1% or 0.01\n"
+	 "iterations are run in chunks of -i iterations per thread, until the target or --max-iterations is reached")
+	("target-measure", po::value< std::string >()->default_value("mean"),
+	 "with --target-relerr, measure whose error is targeted: mean, or a latency percentile, e.g. p99")
+	("max-iterations", po::value<int>(&argmaxiter)->default_value(0),
+	 "with --target-relerr, maximum number of iterations recorded per thread (defaults to 100 times -i)")
+	("think-time", po::value< std::string >(),
+	 "closed loop: time each thread waits between two calls, outside of the timed region\n"
+	 "given as fixed:<time>, exp:<mean> (Poisson arrivals) or lognormal:<median>:<sigma>, e.g. exp:5ms\n"
+	 "TPS achieved, p99 latency and thread utilization are reported")
+	("rate", po::value<double>(&argrate),
+	 "open loop mode: offered rate, in Tnx/s, spread evenly accross threads\n"
+	 "calls are scheduled on a fixed timeline, and latency is measured from the planned time")
+	("rate-sweep", po::value< std::string >(),
+	 "open loop mode: comma-separated list of offered rates to sweep, in Tnx/s\n"
+	 "a load curve (offered load, achieved TPS, p99 latency) is produced for each test case")
+	("ramp", po::value< std::string >(),
+	 "step load profile, given as start:max:increment:interval, e.g. 1:64:8:10s\n"
+	 "threads are added at every step, up to max; TPS and latency percentiles are reported per step\n"
+	 "overrides -t")
+	("threads-sweep", po::value< std::string >(),
+	 "comma-separated list of thread counts, e.g. 1,2,4,8,16\n"
+	 "each test case is run at every count, and the Universal Scalability Law is fitted to the TPS curve\n"
+	 "overrides -t")
+	("clients", po::value<int>(&argclients),
+	 "pipelined mode: number of logical clients (defaults to the number of threads)\n"
+	 "requests from clients are queued, and served by threads acting as carriers")
+	("inflight", po::value<int>(&arginflight)->default_value(1),
+	 "pipelined mode: number of requests each logical client keeps in flight\n"
+	 "queueing delay and service time are reported separately")
+	("mix", po::value< std::string >(),
+	 "mixed workload: comma-separated list of label[/test]:weight, e.g. hmac-256:60,ecdsa-secp256r1:25,rsa-2048/oaepunw:15\n"
+	 "each iteration picks a benchmark by weight; benchmarks must be part of the coverage")
+	("cpus", po::value< std::string >(),
+	 "CPUs on which threads may be placed, e.g. 0-7,16-23 (defaults to all CPUs available to the process)\n"
+	 "implies --placement compact, unless specified")
+	("placement", po::value< std::string >(),
+	 "thread placement policy: compact, scatter or numa\n"
+	 " - compact: one CPU per thread, filling NUMA nodes one after the other\n"
+	 " - scatter: one CPU per thread, spreading threads accross NUMA nodes\n"
+	 " - numa   : all CPUs of a NUMA node per thread, spreading threads accross NUMA nodes")
+	("sched-fifo", po::value<int>(),
+	 "run benchmark threads with the SCHED_FIFO real-time policy, at the given priority\n"
+	 "requires appropriate privileges; see the thread placement facts for what was actually applied")
+	("nice", po::value<int>(), "nice value of benchmark threads")
+	("cpu-usage", "sample the CPU usage of threads around recorded iterations\n"
+	 "CPU time and context switches per call, and the on-CPU and run queue shares of latency are reported")
+	("time-series", po::value< std::string >(),
+	 "split each run in intervals of the given length, e.g. 100ms or 1s\n"
+	 "TPS, latency percentiles and the number of threads inside a call are reported for each interval")
+	("calibrate", "measure the harness overhead timed with each call, by running the benchmark loop with an empty operation")
+	("subtract-overhead", "subtract the harness overhead from latency figures, its error being added to theirs (implies --calibrate)")
+	("histogram", "count the latency of recorded iterations in a histogram, with 3 significant digits\n"
+	 "iterations are summarized instead of kept one by one, tail percentiles are reported,\n"
+	 "and the latency distribution is added to JSON output")
+	("timer", po::value< std::string >()->default_value("steady"),
+	 "clock used to time calls: steady, monotonic-raw, or tsc (invariant time stamp counter, calibrated at startup)")
 	("json,j", "output results as JSON")
 	("jsonfile,o", po::value< std::string >(), "JSON output file name")
 	("coverage,c", po::value< std::string >()->default_value(default_tests),
@@ -202,6 +339,341 @@ int main(int argc, char **argv)
 	std::cerr << cliopts << '\n';
     }
 
+    if (vm.count("duration")) {
+	try {
+	    argduration = parse_duration( vm["duration"].as<std::string>() );
+	} catch (DurationException &e) {
+	    std::cerr << "*** Error: " << e.what() << '\n';
+	    std::exit(EX_USAGE);
+	}
+
+	if (argduration.count() == 0) {
+	    std::cerr << "The duration must be greater than zero\n";
+	    std::exit(EX_USAGE);
+	}
+    }
+
+    // retrieve the deadline and the watchdog limit, if any
+    try {
+	if (vm.count("deadline")) {
+	    argdeadline = parse_duration( vm["deadline"].as<std::string>() );
+	}
+	if (vm.count("watchdog")) {
+	    argwatchdog = parse_duration( vm["watchdog"].as<std::string>() );
+	}
+    } catch (DurationException &e) {
+	std::cerr << "*** Error: " << e.what() << '\n';
+	std::exit(EX_USAGE);
+    }
+
+    if ((vm.count("deadline") && argdeadline.count() == 0) || (vm.count("watchdog") && argwatchdog.count() == 0)) {
+	std::cerr << "The deadline and the watchdog limit must be greater than zero\n";
+	std::exit(EX_USAGE);
+    }
+
+    // retrieve the length of time series intervals, if any
+    if (vm.count("time-series")) {
+	try {
+	    argtimeseries = parse_duration( vm["time-series"].as<std::string>() );
+	} catch (DurationException &e) {
+	    std::cerr << "*** Error: " << e.what() << '\n';
+	    std::exit(EX_USAGE);
+	}
+	if (argtimeseries.count() == 0) {
+	    std::cerr << "The time series interval must be greater than zero\n";
+	    std::exit(EX_USAGE);
+	}
+    }
+
+    if (vm.count("deadline") && vm.count("mix")) {
+	std::cerr << "--deadline cannot be combined with --mix\n";
+	std::exit(EX_USAGE);
+    }
+
+    if (vm.count("tolerate-errors") && (vm.count("mix") || vm.count("clients") || !vm["inflight"].defaulted())) {
+	std::cerr << "--tolerate-errors cannot be combined with --mix nor with pipelined mode\n";
+	std::exit(EX_USAGE);
+    }
+
+    // in open loop or with think time, threads spin while waiting for their next call: that would count as CPU per call
+    if (vm.count("cpu-usage") && (vm.count("mix") || vm.count("rate") || vm.count("rate-sweep") || vm.count("think-time")
+				  || vm.count("clients") || !vm["inflight"].defaulted())) {
+	std::cerr << "--cpu-usage cannot be combined with --mix, --rate, --rate-sweep, --think-time nor with pipelined mode\n";
+	std::exit(EX_USAGE);
+    }
+
+    // with a histogram, iterations are not kept one by one: a ramp could not dispatch them into steps
+    if (vm.count("histogram") && (vm.count("mix") || vm.count("ramp") || vm.count("clients") || !vm["inflight"].defaulted())) {
+	std::cerr << "--histogram cannot be combined with --mix, --ramp nor with pipelined mode\n";
+	std::exit(EX_USAGE);
+    }
+
+    // retrieve the number of iterations to skip, or the maximum number of warm-up iterations for automatic skip
+    try {
+	auto skip = vm["skip"].as<std::string>();
+
+	if (skip.rfind("auto", 0) == 0) {
+	    if (skip != "auto" && skip[4] != ':') {
+		throw std::invalid_argument(skip);
+	    }
+	    argautoskip = skip == "auto" ? 1000 : std::stoi(skip.substr(5));
+	    if (argautoskip < 1) {
+		throw std::invalid_argument(skip);
+	    }
+	} else {
+	    argskipiter = std::stoi(skip);
+	}
+    } catch (std::logic_error &e) {
+	std::cerr << "Invalid number of iterations to skip: " << vm["skip"].as<std::string>() << '\n';
+	std::exit(EX_USAGE);
+    }
+
+    if (argautoskip > 0 && (vm.count("mix") || vm.count("clients") || !vm["inflight"].defaulted())) {
+	std::cerr << "--skip auto cannot be combined with --mix, --clients or --inflight\n";
+	std::exit(EX_USAGE);
+    }
+
+    // retrieve the target of adaptive runs, if any
+    double argtarget = 0.0;
+    double argtargetpercentile = 0.0;
+
+    if (vm.count("target-relerr")) {
+	if (vm.count("duration") || vm.count("ramp") || vm.count("threads-sweep") || vm.count("rate-sweep") || vm.count("mix")
+	    || vm.count("clients") || !vm["inflight"].defaulted() || vm.count("library-b") || vm.count("slot-b")) {
+	    std::cerr << "--target-relerr cannot be combined with --duration, --ramp, --threads-sweep, --rate-sweep, --mix, --clients, --inflight, --library-b or --slot-b\n";
+	    std::exit(EX_USAGE);
+	}
+
+	try {
+	    auto target = vm["target-relerr"].as<std::string>();
+	    bool percent = !target.empty() && target.back() == '%';
+	    argtarget = std::stod(percent ? target.substr(0, target.size() - 1) : target) / (percent ? 100.0 : 1.0);
+
+	    auto measure = vm["target-measure"].as<std::string>();
+	    if (measure != "mean") {
+		if (measure.size() < 2 || measure.front() != 'p') {
+		    throw std::invalid_argument(measure);
+		}
+		argtargetpercentile = std::stod(measure.substr(1)) / 100.0;
+	    }
+	} catch (std::logic_error &e) {
+	    std::cerr << "Invalid target: " << vm["target-relerr"].as<std::string>() << ", " << vm["target-measure"].as<std::string>() << '\n';
+	    std::exit(EX_USAGE);
+	}
+
+	if (argtarget <= 0.0 || argtarget >= 1.0 || argtargetpercentile < 0.0 || argtargetpercentile >= 1.0) {
+	    std::cerr << "The target relative error must be between 0 and 100%, and the percentile between 0 and 100\n";
+	    std::exit(EX_USAGE);
+	}
+
+	if (argiter < 1 || argmaxiter < 0) {
+	    std::cerr << "With --target-relerr, the number of iterations must be at least 1, and the maximum must be positive\n";
+	    std::exit(EX_USAGE);
+	}
+
+	if (argmaxiter == 0) {
+	    argmaxiter = 100 * argiter;
+	}
+    }
+
+    // retrieve think time, if any
+    ThinkTime thinktime;
+
+    if (vm.count("think-time")) {
+	if (vm.count("rate") || vm.count("rate-sweep") || vm.count("clients") || !vm["inflight"].defaulted()) {
+	    std::cerr << "--think-time cannot be combined with --rate, --rate-sweep, --clients or --inflight\n";
+	    std::exit(EX_USAGE);
+	}
+
+	try {
+	    thinktime = ThinkTime( vm["think-time"].as<std::string>() );
+	} catch (ThinkTimeException &e) {
+	    std::cerr << "*** Error: " << e.what() << '\n';
+	    std::exit(EX_USAGE);
+	}
+    }
+
+    // choose the clock used to time calls, before measuring its precision
+    try {
+	CallTimer::use( vm["timer"].as<std::string>() );
+    } catch (CallTimerException &e) {
+	std::cerr << "*** Error: " << e.what() << '\n';
+	std::exit(EX_USAGE);
+    }
+
+    // retrieve the retry policy, if any
+    RetryPolicy retry;
+
+    if (vm.count("retry")) {
+	if (vm.count("mix") || vm.count("clients") || !vm["inflight"].defaulted()) {
+	    std::cerr << "--retry cannot be combined with --mix nor with pipelined mode\n";
+	    std::exit(EX_USAGE);
+	}
+
+	try {
+	    retry = RetryPolicy( vm["retry"].as<std::string>(), vm["retry-on"].as<std::string>() );
+	} catch (RetryPolicyException &e) {
+	    std::cerr << "*** Error: " << e.what() << '\n';
+	    std::exit(EX_USAGE);
+	}
+    }
+
+    // retrieve the mix, if any
+    std::optional<MixProfile> mix;
+
+    if (vm.count("mix")) {
+	if (vm.count("rate") || vm.count("rate-sweep") || vm.count("ramp") || vm.count("threads-sweep")
+	    || vm.count("clients") || !vm["inflight"].defaulted() || vm.count("slots")) {
+	    std::cerr << "--mix cannot be combined with --rate, --rate-sweep, --ramp, --threads-sweep, --clients, --inflight or --slots\n";
+	    std::exit(EX_USAGE);
+	}
+
+	try {
+	    mix.emplace( vm["mix"].as<std::string>() );
+	} catch (MixProfileException &e) {
+	    std::cerr << "*** Error: " << e.what() << '\n';
+	    std::exit(EX_USAGE);
+	}
+    }
+
+    // retrieve thread placement and scheduling, if any
+    Placement placement;
+
+    try {
+	if (vm.count("placement") || vm.count("cpus")) {
+	    placement = Placement( vm.count("placement") ? vm["placement"].as<std::string>() : "compact",
+				   vm.count("cpus") ? vm["cpus"].as<std::string>() : "" );
+	}
+    } catch (PlacementException &e) {
+	std::cerr << "*** Error: " << e.what() << '\n';
+	std::exit(EX_USAGE);
+    }
+
+    if (vm.count("sched-fifo")) {
+	placement.fifo_priority( vm["sched-fifo"].as<int>() );
+    }
+
+    if (vm.count("nice")) {
+	placement.nice( vm["nice"].as<int>() );
+    }
+
+    // pipelined mode is selected when clients or requests in flight are specified
+    bool pipelined = vm.count("clients") || !vm["inflight"].defaulted();
+
+    if (pipelined) {
+	if (vm.count("rate") || vm.count("rate-sweep") || vm.count("ramp") || vm.count("threads-sweep")) {
+	    std::cerr << "--clients and --inflight cannot be combined with --rate, --rate-sweep, --ramp or --threads-sweep\n";
+	    std::exit(EX_USAGE);
+	}
+
+	if (!vm.count("clients")) {
+	    argclients = argnthreads;
+	}
+
+	if (argclients < 1 || arginflight < 1) {
+	    std::cerr << "The number of clients and of requests in flight must be at least 1\n";
+	    std::exit(EX_USAGE);
+	}
+    }
+
+    if (argsessions < 1) {
+	std::cerr << "The number of sessions per thread must be at least 1\n";
+	std::exit(EX_USAGE);
+    }
+
+    if (argprocesses < 1) {
+	std::cerr << "The number of processes must be at least 1\n";
+	std::exit(EX_USAGE);
+    }
+
+    if (argprocesses > 1 && pipelined) {
+	std::cerr << "--processes cannot be combined with --clients or --inflight\n";
+	std::exit(EX_USAGE);
+    }
+
+    if (argminiter < 0) {
+	std::cerr << "The minimum number of iterations must be positive\n";
+	std::exit(EX_USAGE);
+    }
+
+    if (argrate < 0.0) {
+	std::cerr << "The offered rate must be positive\n";
+	std::exit(EX_USAGE);
+    }
+
+    if (vm.count("rate") && vm.count("rate-sweep")) {
+	std::cerr << "--rate cannot be combined with --rate-sweep\n";
+	std::exit(EX_USAGE);
+    }
+
+    // retrieve the offered rates to sweep, if any
+    RateCoverage rates{ vm.count("rate-sweep") ? vm["rate-sweep"].as<std::string>() : "" };
+
+    if (vm.count("rate-sweep") && rates.begin() == rates.end()) {
+	std::cerr << "Invalid offered rates for sweep: " << vm["rate-sweep"].as<std::string>() << '\n';
+	std::exit(EX_USAGE);
+    }
+
+    // retrieve the ramp profile, if any
+    std::optional<RampProfile> ramp;
+
+    if (vm.count("ramp")) {
+	if (vm.count("rate") || vm.count("rate-sweep") || vm.count("duration")) {
+	    std::cerr << "--ramp cannot be combined with --rate, --rate-sweep or --duration\n";
+	    std::exit(EX_USAGE);
+	}
+
+	try {
+	    ramp.emplace( vm["ramp"].as<std::string>() );
+	} catch (RampProfileException &e) {
+	    std::cerr << "*** Error: " << e.what() << '\n';
+	    std::exit(EX_USAGE);
+	}
+
+	// we need as many threads (and sessions) as the ramp reaches
+	argnthreads = static_cast<int>(ramp->maxthreads());
+    }
+
+    // retrieve the thread counts to sweep, if any
+    ThreadCoverage threadlevels{ vm.count("threads-sweep") ? vm["threads-sweep"].as<std::string>() : "" };
+
+    if (vm.count("threads-sweep")) {
+	if (vm.count("ramp") || vm.count("rate-sweep")) {
+	    std::cerr << "--threads-sweep cannot be combined with --ramp or --rate-sweep\n";
+	    std::exit(EX_USAGE);
+	}
+
+	if (threadlevels.begin() == threadlevels.end() || threadlevels.contains(0u)) {
+	    std::cerr << "Invalid thread counts for sweep: " << vm["threads-sweep"].as<std::string>() << '\n';
+	    std::exit(EX_USAGE);
+	}
+
+	// sessions and keys are created once, for the highest count
+	argnthreads = static_cast<int>(*std::max_element(threadlevels.begin(), threadlevels.end()));
+    }
+
+    // retrieve slots to route calls to, if any
+    std::unique_ptr<Router> router;
+
+    if (vm.count("slots")) {
+	SlotCoverage slotlist{ vm["slots"].as<std::string>() };
+
+	if (slotlist.begin() == slotlist.end()) {
+	    std::cerr << "Invalid slot list: " << vm["slots"].as<std::string>() << '\n';
+	    std::exit(EX_USAGE);
+	}
+
+	try {
+	    router = std::make_unique<Router>( vm["routing"].as<std::string>(), std::vector<int>(slotlist.begin(), slotlist.end()) );
+	} catch (RouterException &e) {
+	    std::cerr << "*** Error: " << e.what() << '\n';
+	    std::exit(EX_USAGE);
+	}
+
+	// the first slot is the one described below
+	argslot = router->slot(0);
+    }
+
     if (vm.count("nogenerate")) {
 	generate_session_keys = false;
     }
@@ -212,11 +684,71 @@ int main(int argc, char **argv)
 	std::exit(EX_USAGE);
     }
 
-    if(argnthreads>hwthreads) {
-	std::cerr << "*** Warning: the specified number of threads (" << argnthreads << ") exceeds the hardware capacity on this platform (" << hwthreads << ").\n";
+    // A/B comparison: what is not specified for B is taken from A
+    bool ab = vm.count("library-b") || vm.count("slot-b");
+    std::string library_b;
+    int argslot_b = -1;
+
+    if (ab) {
+	if (mix || ramp || pipelined || router || vm.count("threads-sweep") || vm.count("rate-sweep")) {
+	    std::cerr << "--library-b and --slot-b cannot be combined with --mix, --ramp, --clients, --inflight, --slots, --threads-sweep or --rate-sweep\n";
+	    std::exit(EX_USAGE);
+	}
+
+	if (argabrounds < 1) {
+	    std::cerr << "The number of A/B rounds must be at least 1\n";
+	    std::exit(EX_USAGE);
+	}
+
+	library_b = vm.count("library-b") ? vm["library-b"].as<std::string>() : vm["library"].as<std::string>();
+	argslot_b = vm.count("slot-b") ? vm["slot-b"].as<int>() : argslot;
+
+	if (library_b == vm["library"].as<std::string>() && argslot_b == argslot) {
+	    std::cerr << "A and B designate the same library and slot, nothing to compare\n";
+	    std::exit(EX_USAGE);
+	}
+    }
+
+    if(argnthreads*argprocesses>hwthreads) {
+	std::cerr << "*** Warning: the specified number of threads (" << argnthreads*argprocesses << ") exceeds the hardware capacity on this platform (" << hwthreads << ").\n";
 	std::cerr << "*** TPS and latency figures may be affected.\n\n";
     }
 
+    // with several processes, they must be forked before the PKCS#11 library is loaded
+    std::unique_ptr<ProcessGroup> group;
+
+    if(argprocesses > 1) {
+	try {
+	    group = std::make_unique<ProcessGroup>(argprocesses);
+	} catch (ProcessGroupException &e) {
+	    std::cerr << "*** Error: " << e.what() << '\n';
+	    std::exit(EX_OSERR);
+	}
+
+	if(!group->leader()) {
+	    // only the leader reports, output of other processes is discarded
+	    int devnull = open("/dev/null", O_WRONLY);
+	    dup2(devnull, STDOUT_FILENO);
+	    close(devnull);
+	    json = false;
+	    if(jsonout.is_open()) {
+		jsonout.close();
+	    }
+	}
+
+	placement.first_thread(group->rank() * argnthreads);
+    }
+
+    // output_json(): write results gathered so far, if requested
+    auto output_json = [&] () {
+	if(json==true) {
+	    boost::property_tree::write_json(jsonout.is_open() ? jsonout : std::cout, results);
+	    if(jsonout.is_open()) {
+		std::cout << "output written to " << vm["jsonfile"].as<std::string>() << '\n';
+	    }
+	}
+    };
+
     p11::Module module( vm["library"].as<std::string>() );
 
     p11::Info info = module.get_info();
@@ -238,7 +770,7 @@ int main(int argc, char **argv)
     p11::Slot slot( module, slotids.at( argslot ) );
 
     // print chosen slot index
-    std::cout << "Slot index: " << vm["slot"].as<int>() << '\n';
+    std::cout << "Slot index: " << argslot << '\n';
     // print chosen slot index
     std::cout << "Slot number: " << slotids.at(argslot) << " (0x" << std::hex << slotids.at(argslot) << std::dec << ")\n";
     // print firmware version of the slot
@@ -290,23 +822,70 @@ int main(int argc, char **argv)
 		      << std::to_string( token_info.firmwareVersion.major ) << '.'
 		      << std::to_string( token_info.firmwareVersion.minor ) << '\n';
 
-	    // login all sessions (one per thread)
-	    std::vector<std::unique_ptr<p11::Session> > sessions;
-	    for(int i=0; i<argnthreads; ++i) {
-		std::unique_ptr<p11::Session> session ( new Session(slot, false) );
-		std::string argpwd { vm["password"].as<std::string>() };
-		p11::secure_string pwd( argpwd.data(), argpwd.data()+argpwd.length() );
-		try {
-		    session->login(p11::UserType::User, pwd );
-		} catch (p11::PKCS11_ReturnError &err) {
-		    // we ignore if we get CKR_ALREADY_LOGGED_IN, as login status is shared accross all sessions.
-		    if (err.get_return_value() != p11::ReturnValue::UserAlreadyLoggedIn) {
-			// re-throw
-			throw;
+	    // slots where sessions are opened. With --slots, the first one is the slot described above
+	    std::vector<p11::Slot> slots { slot };
+	    slots.reserve(router ? router->slots() : 1);
+	    for(size_t s=1; router && s<router->slots(); s++) {
+		auto index = router->slot(s);
+		slots.emplace_back( module, slotids.at(index) );
+		std::cout << "Additional slot index: " << index << ", number: " << slotids.at(index) << " (0x" << std::hex << slotids.at(index) << std::dec << ")\n";
+	    }
+	    const int nslots = static_cast<int>(slots.size());
+
+	    // login all sessions (argsessions per thread, on each slot)
+	    // sessions of a thread are grouped by slot, see KeyGenerator
+	    auto login_sessions = [&] (std::vector<p11::Slot> &sessionslots, const std::string &argpwd) {
+		std::vector<std::unique_ptr<p11::Session> > rv;
+		const int count = static_cast<int>(sessionslots.size());
+		for(int i=0; i<argnthreads*count*argsessions; ++i) {
+		    std::unique_ptr<p11::Session> session ( new Session(sessionslots[(i / argsessions) % count], false) );
+		    p11::secure_string pwd( argpwd.data(), argpwd.data()+argpwd.length() );
+		    try {
+			session->login(p11::UserType::User, pwd );
+		    } catch (p11::PKCS11_ReturnError &err) {
+			// we ignore if we get CKR_ALREADY_LOGGED_IN, as login status is shared accross all sessions.
+			if (err.get_return_value() != p11::ReturnValue::UserAlreadyLoggedIn) {
+			    // re-throw
+			    throw;
+			}
 		    }
+
+		    rv.push_back(std::move(session)); // move session to sessions
 		}
+		return rv;
+	    };
 
-		sessions.push_back(std::move(session)); // move session to sessions
+	    std::vector<std::unique_ptr<p11::Session> > sessions = login_sessions(slots, vm["password"].as<std::string>());
+
+	    // A/B comparison: B has its own library (unless shared with A), slot and sessions
+	    std::unique_ptr<p11::Module> module_b;
+	    std::vector<p11::Slot> slots_b;
+	    std::vector<std::unique_ptr<p11::Session> > sessions_b;
+
+	    if(ab) {
+		if(library_b != vm["library"].as<std::string>()) {
+		    module_b = std::make_unique<p11::Module>( library_b );
+		}
+		p11::Module &b = module_b ? *module_b : module;
+
+		p11::Info info_b = b.get_info();
+		std::vector<p11::SlotId> slotids_b = p11::Slot::get_available_slots( b, false );
+		slots_b.emplace_back( b, slotids_b.at( argslot_b ) );
+		p11::TokenInfo token_info_b = slots_b.front().get_token_info();
+
+		std::cout << "B library path: " << library_b << '\n'
+			  << "B library version: "
+			  << std::to_string( info_b.libraryVersion.major ) << '.'
+			  << std::to_string( info_b.libraryVersion.minor ) << '\n'
+			  << "B slot index: " << argslot_b << '\n'
+			  << "B slot number: " << slotids_b.at(argslot_b) << " (0x" << std::hex << slotids_b.at(argslot_b) << std::dec << ")\n"
+			  << "B token label: " << std::string_view( reinterpret_cast<const char *>(token_info_b.label), sizeof(token_info_b.label) ) << '\n'
+			  << "B token model: " << std::string_view( reinterpret_cast<const char *>(token_info_b.model), sizeof(token_info_b.model) ) << '\n'
+			  << "B token firmware version: "
+			  << std::to_string( token_info_b.firmwareVersion.major ) << '.'
+			  << std::to_string( token_info_b.firmwareVersion.minor ) << '\n';
+
+		sessions_b = login_sessions(slots_b, vm.count("password-b") ? vm["password-b"].as<std::string>() : vm["password"].as<std::string>());
 	    }
 
 	    // generate test vectors, according to command line requirements
@@ -320,14 +899,70 @@ int main(int argc, char **argv)
 	    }
 
 	    auto epsilon = measure_clock_precision();
-	    std::cout << std::endl << "timer granularity (ns): " << epsilon.first << " +/- " << epsilon.second << "\n\n";
+	    std::cout << std::endl << "timer: " << CallTimer::clock() << '\n'
+		      << "timer granularity (ns): " << epsilon.first << " +/- " << epsilon.second << "\n\n";
 
-	    Executor executor( testvecs, sessions, argnthreads, epsilon, generate_session_keys==true );
+	    // the watchdog outlives executors, as their workers are bound to it
+	    std::unique_ptr<Watchdog> watchdog;
+	    if(argwatchdog.count() > 0) {
+		watchdog = std::make_unique<Watchdog>( argwatchdog );
+	    }
 
-	    if(generate_session_keys) {
-		KeyGenerator keygenerator( sessions, argnthreads, vendor );
+	    // so does the trace. Each process writes its own
+	    std::unique_ptr<Trace> trace;
+	    if(vm.count("trace")) {
+		auto path = vm["trace"].as<std::string>();
+		if(group && !group->leader()) {
+		    path += "." + std::to_string(group->rank());
+		}
+		trace = std::make_unique<Trace>( path, group ? group->rank() : 0 );
+	    }
+
+	    // close_trace(): write what is left of the trace, and tell how it went
+	    auto close_trace = [&trace] () {
+		if(trace) {
+		    trace->close();
+		    std::cout << "trace: " << trace->written() << " calls written to " << trace->path();
+		    if(trace->dropped() > 0) {
+			std::cout << ", " << trace->dropped() << " calls dropped as the collector could not keep up";
+		    }
+		    std::cout << std::endl;
+		}
+	    };
+
+	    // in A/B comparisons, calls are watched and traced under the arm of their executor
+	    Executor executor( testvecs, sessions, argnthreads, argsessions*nslots, epsilon, generate_session_keys==true, placement, group.get(), watchdog.get(), trace.get(), ab ? "A" : "" );
+
+	    // B runs the same threads, vectors and keys, on its own sessions
+	    std::unique_ptr<Executor> executor_b;
+	    if(ab) {
+		executor_b = std::make_unique<Executor>( testvecs, sessions_b, argnthreads, argsessions, epsilon, generate_session_keys==true, placement, group.get(), watchdog.get(), trace.get(), "B" );
+	    }
+
+	    // sessions lost during a run are reopened by the retry policy, and logged in again
+	    if(retry.enabled()) {
+		executor.reopen_with(vm["password"].as<std::string>());
+		if(executor_b) {
+		    executor_b->reopen_with(vm.count("password-b") ? vm["password-b"].as<std::string>() : vm["password"].as<std::string>());
+		}
+	    }
+
+	    // the harness overhead is measured by the same threads, with the same timer as benchmarks
+	    if(vm.count("calibrate") || vm.count("subtract-overhead")) {
+		const size_t calibration_iterations = 10000;
+		auto overhead = executor.calibrate(calibration_iterations);
+		std::cout << "harness overhead (ns): " << overhead.mean << " +/- " << overhead.error
+			  << " (minimum " << overhead.minimum << ", median " << overhead.median
+			  << ", p99 " << overhead.p99 << ", maximum " << overhead.maximum << ")\n\n";
+		if(executor_b) {
+		    executor_b->calibrate(calibration_iterations);
+		}
+	    }
+
+	    // generate session keys on a set of sessions, according to command line requirements
+	    auto generate_keys = [&] (std::vector<std::unique_ptr<p11::Session> > &keysessions, int keyslots) {
+		KeyGenerator keygenerator( keysessions, argnthreads, keyslots, argsessions, vendor );
 
-		std::cout << "Generating session keys for " << argnthreads << " thread(s)\n";
 		if(tests.contains("rsa")
 		   || tests.contains("jwe")
 		   || tests.contains("jweoaepsha1")
@@ -388,7 +1023,16 @@ int main(int argc, char **argv)
 		if(tests.contains("rand")) {
 		    keygenerator.generate_key(KeyGenerator::KeyType::AES, "rand-128", 128); // not really used
 		}
+	    };
+
+	    if(generate_session_keys) {
+		std::cout << "Generating session keys for " << argnthreads << " thread(s)\n";
+		generate_keys(sessions, nslots);
 
+		if(executor_b) {
+		    std::cout << "Generating session keys on B\n";
+		    generate_keys(sessions_b, 1);
+		}
 	    }
 
 	    std::forward_list<P11Benchmark *> benchmarks;
@@ -556,21 +1200,89 @@ int main(int argc, char **argv)
 	    boost::copy(testvecs | boost::adaptors::map_keys, std::front_inserter(testvecsnames));
 	    testvecsnames.sort();	// sort in alphabetical order
 
-	    for(auto benchmark : benchmarks) {
-		results.add_child( benchmark->name()+" using "+benchmark->label(), executor.benchmark( *benchmark, argiter, argskipiter, testvecsnames ));
-		free(benchmark);
-	    }
+	    ExecutionPlan plan { static_cast<size_t>(argiter), static_cast<size_t>(argskipiter) };
+	    plan.rate = argrate;
+	    plan.duration = argduration;
+	    plan.miniterations = static_cast<size_t>(argminiter);
+	    plan.thinktime = thinktime;
+	    plan.router = router.get();
+	    plan.autoskip = static_cast<size_t>(argautoskip);
+	    plan.target_relerr = argtarget;
+	    plan.deadline = argdeadline;
+	    plan.tolerate_errors = vm.count("tolerate-errors") > 0;
+	    plan.retry = retry;
+	    plan.cpu_usage = vm.count("cpu-usage") > 0;
+	    plan.histogram = vm.count("histogram") > 0;
+	    plan.sample_interval = argtimeseries;
+	    plan.subtract_overhead = vm.count("subtract-overhead") > 0;
+	    plan.target_percentile = argtargetpercentile;
+	    plan.maxiterations = static_cast<size_t>(argmaxiter);
+
+	    // a call stuck in the library cannot be interrupted: leave before unwinding,
+	    // as destroying the executor and the sessions would wait for it
+	    try {
+		if(mix) {
+		    // each entry of the mix designates the first matching benchmark
+		    std::vector<P11Benchmark *> mixed;
+
+		    for(auto &entry: mix->entries()) {
+			auto it = std::find_if(benchmarks.begin(), benchmarks.end(), [&entry] (auto benchmark) { return entry.matches(*benchmark); });
+			if(it == benchmarks.end()) {
+			    std::cerr << "*** Error: no benchmark matches mix entry " << entry.to_string() << ", check --coverage and --keysizes\n";
+			    rv = EX_USAGE;
+			    break;
+			}
+			mixed.push_back(*it);
+		    }
 
-	    if(json==true) {
-		boost::property_tree::write_json(jsonout.is_open() ? jsonout : std::cout, results);
-		if(jsonout.is_open()) {
-		    std::cout << "output written to " << vm["jsonfile"].as<std::string>() << '\n';
+		    if(rv == EXIT_SUCCESS) {
+			results.add_child( "Mixed workload", executor.mix( mixed, *mix, plan, testvecsnames ));
+		    }
+		    benchmarks.remove_if( [] (auto benchmark) { delete benchmark; return true; } );
 		}
+
+		for(auto benchmark : benchmarks) {
+		    if(ramp) {
+			results.add_child( benchmark->name()+" using "+benchmark->label(), executor.ramp( *benchmark, plan, *ramp, testvecsnames ));
+		    } else if(pipelined) {
+			results.add_child( benchmark->name()+" using "+benchmark->label(), executor.pipeline( *benchmark, plan, argclients, arginflight, testvecsnames ));
+		    } else if(vm.count("threads-sweep")) {
+			results.add_child( benchmark->name()+" using "+benchmark->label(), executor.threads_sweep( *benchmark, plan, threadlevels, testvecsnames ));
+		    } else if(executor_b) {
+			results.add_child( benchmark->name()+" using "+benchmark->label(),
+					   executor.compare( *benchmark, *executor_b, plan, static_cast<size_t>(argabrounds),
+							     { vm["library"].as<std::string>() + ", slot " + std::to_string(argslot),
+							       library_b + ", slot " + std::to_string(argslot_b) },
+							     testvecsnames ));
+		    } else if(vm.count("rate-sweep")) {
+			results.add_child( benchmark->name()+" using "+benchmark->label(), executor.rate_sweep( *benchmark, plan, rates, testvecsnames ));
+		    } else {
+			results.add_child( benchmark->name()+" using "+benchmark->label(), executor.benchmark( *benchmark, plan, testvecsnames ));
+		    }
+		    free(benchmark);
+		}
+	    } catch ( WatchdogException &e) {
+		std::cerr << "Ouch, a call did not return: " << e.what() << '\n'
+			  << "bailing out" << std::endl;
+		close_trace();
+		output_json();
+		if(group) {
+		    group->abort();
+		}
+		std::cout.flush();
+		jsonout.flush();
+		std::_Exit(EX_SOFTWARE);
 	    }
+
+	    close_trace();
+	    output_json();
 	}
 	catch ( KeyGenerationException &e) {
 	    std::cerr << "Ouch, got an error while generating keys: " << e.what() << '\n'
 		      << "bailing out" << std::endl;
+	    if(group) {
+		group->abort();
+	    }
 	}
 	catch ( std::exception &e) {
 	    std::cerr << "Ouch, got an error while execution: " << e.what() << '\n'
@@ -578,6 +1290,9 @@ int main(int argc, char **argv)
 		      << boost::current_exception_diagnostic_information() << '\n'
 		      << "bailing out" << std::endl;
 	    rv = EX_SOFTWARE;
+	    if(group) {
+		group->abort();
+	    }
 	}
 	catch (...) {
 	    std::cerr << "Ouch, got an error while execution\n"
@@ -585,9 +1300,19 @@ int main(int argc, char **argv)
 		      << boost::current_exception_diagnostic_information() << '\n'
 		      << "bailing out" << std::endl;
 	    rv = EX_SOFTWARE;
+	    if(group) {
+		group->abort();
+	    }
 	}
     } else {
       std::cout << "The slot at index " << argslot << " has no token. Aborted.\n";
     }
+
+    // the leader waits for the other processes
+    if(group && group->leader() && !group->wait()) {
+	std::cerr << "*** Error: a process of the group has failed\n";
+	rv = EX_SOFTWARE;
+    }
+
     return rv;
 }
@@ -0,0 +1,71 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// p11tracedump.cpp: dump a binary trace written by p11perftest --trace, as CSV
+
+#include <iostream>
+#include <sysexits.h>		// BSD exit codes
+#include "tracereader.hpp"
+#include "errorcodes.hpp"
+
+// one line per call. Times are in ns: start and end since the Unix epoch, on the system clock
+// at the time the trace was opened, and latency. Lines are ordered by start time for each worker,
+// but interleaved between workers; sort them on the start column for a global timeline.
+int main(int argc, char **argv)
+{
+    if(argc < 2) {
+	std::cerr << "usage: " << argv[0] << " trace.p11t [...]\n"
+		  << "dump traces written by p11perftest --trace, as CSV on the standard output\n";
+	return EX_USAGE;
+    }
+
+    int rv = EX_OK;
+
+    std::cout << "rank,worker,testcase,vector,session,start,end,latency,returncode,retries\n";
+
+    for(int i=1; i<argc; i++) {
+	try {
+	    TraceReader trace(argv[i]);
+
+	    trace.for_each([&trace] (const trace_event_t &event) {
+			       auto &[name, vector] = trace.testcase(event.testcase);
+			       std::cout << trace.rank() << ','
+					 << event.worker << ','
+					 << '"' << name << "\","
+					 << vector << ','
+					 << event.session << ','
+					 << trace.realtime() + event.start << ','
+					 << trace.realtime() + event.end << ','
+					 << event.end - event.start << ','
+					 << errorcode(static_cast<int>(event.rc)) << ','
+					 << event.retries << '\n';
+			   });
+
+	    if(!trace.complete()) {
+		std::cerr << argv[i] << ": the trace was not closed, it may be truncated\n";
+	    } else if(trace.dropped() > 0) {
+		std::cerr << argv[i] << ": " << trace.dropped() << " calls were not traced, as the collector could not keep up\n";
+	    }
+	} catch (std::exception &e) {
+	    std::cerr << argv[i] << ": " << e.what() << '\n';
+	    rv = EX_DATAERR;
+	}
+    }
+
+    return rv;
+}
@@ -0,0 +1,267 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// placement.cpp: a class to place threads on CPUs and NUMA nodes, and to set their scheduling policy
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <set>
+#include <boost/tokenizer.hpp>
+#include "placement.hpp"
+
+#if defined(HAVE_PTHREAD_SETAFFINITY_NP)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+// parse_cpulist(): parse a list of CPUs, as found in /sys, e.g. "0-7,16-23"
+static std::set<int> parse_cpulist(const std::string &cpulist)
+{
+    std::set<int> rv;
+    boost::char_separator<char> sep(",\n");
+    boost::tokenizer<boost::char_separator<char>> toparse(cpulist, sep);
+
+    for(auto token: toparse) {
+	char *end = nullptr;
+	auto first = strtol(token.c_str(), &end, 10);
+	auto last = first;
+
+	if(*end == '-') {
+	    last = strtol(end+1, &end, 10);
+	}
+
+	if(end == token.c_str() || *end != '\0' || first < 0 || last < first) {
+	    throw PlacementException("invalid CPU list: " + cpulist);
+	}
+
+	for(auto cpu = first; cpu <= last; cpu++) {
+	    rv.insert(static_cast<int>(cpu));
+	}
+    }
+
+    return rv;
+}
+
+// format_cpulist(): the reverse of parse_cpulist()
+static std::string format_cpulist(const std::vector<int> &cpus)
+{
+    std::ostringstream rv;
+
+    for(size_t i=0; i<cpus.size(); ) {
+	size_t j = i;
+	while(j+1 < cpus.size() && cpus[j+1] == cpus[j]+1) {
+	    j++;
+	}
+	rv << (i>0 ? "," : "") << cpus[i];
+	if(j>i) {
+	    rv << '-' << cpus[j];
+	}
+	i = j+1;
+    }
+
+    return rv.str();
+}
+
+
+Placement::Placement(const std::string &policy, const std::string &cpulist)
+{
+    if(policy == "compact") {
+	m_policy = Policy::compact;
+    } else if(policy == "scatter") {
+	m_policy = Policy::scatter;
+    } else if(policy == "numa") {
+	m_policy = Policy::numa;
+    } else {
+	throw PlacementException("unknown placement policy: " + policy);
+    }
+
+#if defined(HAVE_PTHREAD_SETAFFINITY_NP)
+    std::set<int> allowed;
+
+    if(cpulist.empty()) {
+	// by default, all CPUs we are allowed to run on
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	sched_getaffinity(0, sizeof(cpuset), &cpuset);
+	for(int cpu=0; cpu<CPU_SETSIZE; cpu++) {
+	    if(CPU_ISSET(cpu, &cpuset)) {
+		allowed.insert(cpu);
+	    }
+	}
+    } else {
+	allowed = parse_cpulist(cpulist);
+    }
+
+    // retrieve NUMA topology from sysfs. if not available, all CPUs are on a single node.
+    std::set<int> placed;
+    for(int node=0; ; node++) {
+	std::ifstream nodefile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+	if(!nodefile) {
+	    break;
+	}
+
+	std::string nodelist;
+	std::getline(nodefile, nodelist);
+
+	std::vector<int> nodecpus;
+	for(auto cpu: parse_cpulist(nodelist)) {
+	    if(allowed.count(cpu)) {
+		nodecpus.push_back(cpu);
+		placed.insert(cpu);
+	    }
+	}
+
+	if(!nodecpus.empty()) {
+	    m_nodes.push_back(nodecpus);
+	}
+    }
+
+    // CPUs not found in any node, if any, make a node of their own
+    std::vector<int> orphans;
+    std::set_difference(allowed.begin(), allowed.end(), placed.begin(), placed.end(), std::back_inserter(orphans));
+    if(!orphans.empty()) {
+	m_nodes.push_back(orphans);
+    }
+
+    for(auto &node: m_nodes) {
+	m_cpus.insert(m_cpus.end(), node.begin(), node.end());
+    }
+
+    if(m_cpus.empty()) {
+	throw PlacementException("no CPU available for placement");
+    }
+#else
+    throw PlacementException("thread placement is not supported on this platform");
+#endif
+}
+
+
+std::string Placement::policy() const
+{
+    std::ostringstream rv;
+
+    switch(m_policy) {
+    case Policy::none:
+	rv << "none";
+	break;
+
+    case Policy::compact:
+	rv << "compact";
+	break;
+
+    case Policy::scatter:
+	rv << "scatter";
+	break;
+
+    case Policy::numa:
+	rv << "numa";
+	break;
+    }
+
+    if(m_policy != Policy::none) {
+	rv << " over CPUs " << format_cpulist(m_cpus) << " (" << m_nodes.size() << " node(s))";
+    }
+
+    if(m_fifo_priority) {
+	rv << ", SCHED_FIFO priority " << *m_fifo_priority;
+    }
+
+    if(m_nice) {
+	rv << ", nice " << *m_nice;
+    }
+
+    return rv.str();
+}
+
+
+std::vector<int> Placement::cpus(size_t thread) const
+{
+    switch(m_policy) {
+    case Policy::compact:
+	return { m_cpus[thread % m_cpus.size()] };
+
+    case Policy::scatter: {
+	auto &node = m_nodes[thread % m_nodes.size()];
+	return { node[(thread / m_nodes.size()) % node.size()] };
+    }
+
+    case Policy::numa:
+	return m_nodes[thread % m_nodes.size()];
+
+    default:
+	return {};
+    }
+}
+
+
+std::string Placement::apply(size_t thread) const
+{
+    std::ostringstream rv;
+
+#if defined(HAVE_PTHREAD_SETAFFINITY_NP)
+    auto wanted = cpus(m_first + thread);
+
+    if(!wanted.empty()) {
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	for(auto cpu: wanted) {
+	    CPU_SET(cpu, &cpuset);
+	}
+	pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+    }
+
+    // report the affinity actually in effect
+    cpu_set_t effective;
+    CPU_ZERO(&effective);
+    pthread_getaffinity_np(pthread_self(), sizeof(effective), &effective);
+
+    std::vector<int> effective_cpus;
+    for(int cpu=0; cpu<CPU_SETSIZE; cpu++) {
+	if(CPU_ISSET(cpu, &effective)) {
+	    effective_cpus.push_back(cpu);
+	}
+    }
+    rv << "cpus " << format_cpulist(effective_cpus);
+
+    if(m_fifo_priority) {
+	sched_param param {};
+	param.sched_priority = *m_fifo_priority;
+	rv << ", SCHED_FIFO " << *m_fifo_priority;
+	if(pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+	    rv << " (denied)";
+	}
+    }
+
+    if(m_nice) {
+	// on Linux, the nice value applies to a single thread
+	rv << ", nice " << *m_nice;
+	if(setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), *m_nice) != 0) {
+	    rv << " (denied)";
+	}
+    }
+#else
+    rv << "not supported";
+#endif
+
+    return rv.str();
+}
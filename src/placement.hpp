@@ -0,0 +1,76 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// placement.hpp: a class to place threads on CPUs and NUMA nodes, and to set their scheduling policy
+
+#if !defined(PLACEMENT_H)
+#define PLACEMENT_H
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <stdexcept>
+#include "../config.h"
+
+struct PlacementException : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+};
+
+// threads are placed on a set of allowed CPUs (by default, all CPUs the process may run on), using a policy:
+// - compact: each thread is pinned to one CPU, filling NUMA nodes one after the other
+// - scatter: each thread is pinned to one CPU, spreading threads round-robin accross NUMA nodes
+// - numa:    each thread is pinned to all CPUs of a NUMA node, spreading threads round-robin accross nodes
+class Placement
+{
+public:
+    enum class Policy { none, compact, scatter, numa };
+
+private:
+    Policy m_policy { Policy::none };
+    std::vector<std::vector<int> > m_nodes; // allowed CPUs, per NUMA node
+    std::vector<int> m_cpus;		    // allowed CPUs, ordered by NUMA node
+    std::optional<int> m_fifo_priority;	    // SCHED_FIFO priority, if requested
+    std::optional<int> m_nice;		    // nice value, if requested
+    size_t m_first { 0 };		    // index of our first thread, when several processes share the CPUs
+
+public:
+    Placement() = default;	// no placement, default scheduling
+
+    // policy is one of compact, scatter or numa. cpulist restricts allowed CPUs, e.g. "0-7,16-23"
+    Placement(const std::string &policy, const std::string &cpulist);
+
+    inline void fifo_priority(int priority) { m_fifo_priority = priority; }
+    inline void nice(int nice) { m_nice = nice; }
+
+    // first_thread(): with several processes, threads of a process are placed after those of the previous ones
+    inline void first_thread(size_t first) { m_first = first; }
+
+    inline bool enabled() const { return m_policy != Policy::none || m_fifo_priority || m_nice; }
+
+    // policy(): a description of the requested placement and scheduling
+    std::string policy() const;
+
+    // cpus(): the CPUs on which a thread is to be pinned (empty if no placement)
+    std::vector<int> cpus(size_t thread) const;
+
+    // apply(): apply placement and scheduling to the calling thread,
+    // and return a description of what was actually applied
+    std::string apply(size_t thread) const;
+};
+
+#endif // PLACEMENT_H
@@ -0,0 +1,457 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// processgroup.cpp: a group of processes, running the same benchmarks concurrently, and sharing their results
+
+#include <atomic>
+#include <cstring>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "processgroup.hpp"
+
+// spinning budget at the process barrier, before falling back to sleeping, see Barrier
+static constexpr std::chrono::microseconds spinning { 200 };
+// when sleeping at the process barrier, how often we check the barrier
+static constexpr std::chrono::microseconds polling { 20 };
+
+struct ProcessGroup::Shared {
+    std::atomic<size_t> arrived { 0 };	  // number of processes arrived at the barrier
+    std::atomic<size_t> generation { 0 }; // incremented each time the barrier opens
+    std::atomic<bool> aborted { false };  // a process has failed
+    ActiveWindow window;		  // see window()
+};
+
+static_assert(std::atomic<size_t>::is_always_lock_free, "process barrier requires lock-free atomics");
+
+
+// serialization helpers: results are exchanged as a flat sequence of 64 bits words
+
+template<typename T> static void put(std::vector<int64_t> &out, const std::vector<T> &v)
+{
+    out.push_back(static_cast<int64_t>(v.size()));
+    for(auto item: v) {
+	out.push_back(static_cast<int64_t>(item));
+    }
+}
+
+template<typename T> static void get(const int64_t *&in, std::vector<T> &v)
+{
+    auto size = static_cast<size_t>(*in++);
+    v.reserve(size);
+    for(size_t i=0; i<size; i++) {
+	v.push_back(static_cast<T>(*in++));
+    }
+}
+
+
+// doubles are exchanged as their bit pattern
+static int64_t word(double value)
+{
+    int64_t rv;
+    std::memcpy(&rv, &value, sizeof rv);
+    return rv;
+}
+
+static double real(int64_t word)
+{
+    double rv;
+    std::memcpy(&rv, &word, sizeof rv);
+    return rv;
+}
+
+static void put(std::vector<int64_t> &out, const moments_t &moments)
+{
+    out.push_back(static_cast<int64_t>(moments.count));
+    for(auto value: { moments.mean, moments.m2, moments.min, moments.max, moments.sum }) {
+	out.push_back(word(value));
+    }
+}
+
+static void get(const int64_t *&in, moments_t &moments)
+{
+    moments.count = static_cast<size_t>(*in++);
+    for(auto value: { &moments.mean, &moments.m2, &moments.min, &moments.max, &moments.sum }) {
+	*value = real(*in++);
+    }
+}
+
+static void put(std::vector<int64_t> &out, const LatencyHistogram &histogram)
+{
+    auto counters = histogram.sparse();
+    out.push_back(static_cast<int64_t>(counters.size()));
+    for(auto [index, count]: counters) {
+	out.push_back(static_cast<int64_t>(index));
+	out.push_back(static_cast<int64_t>(count));
+    }
+    out.push_back(histogram.max());
+}
+
+static void get(const int64_t *&in, LatencyHistogram &histogram)
+{
+    std::vector<std::pair<size_t, std::uint64_t> > counters(static_cast<size_t>(*in++));
+    for(auto &counter: counters) {
+	counter.first = static_cast<size_t>(*in++);
+	counter.second = static_cast<std::uint64_t>(*in++);
+    }
+    if(!counters.empty()) {
+	histogram.from_sparse(counters, *in);
+    }
+    in++;
+}
+
+static void put(std::vector<int64_t> &out, const latency_summary_t &latency)
+{
+    put(out, latency.moments);
+    put(out, latency.histogram);
+}
+
+static void get(const int64_t *&in, latency_summary_t &latency)
+{
+    get(in, latency.moments);
+    get(in, latency.histogram);
+}
+
+static void put(std::vector<int64_t> &out, const call_summary_t &summary)
+{
+    put(out, summary.latency);
+    out.push_back(static_cast<int64_t>(summary.deadline_met));
+    put(out, summary.errors);
+    out.push_back(static_cast<int64_t>(summary.error_codes.size()));
+    for(auto [code, count]: summary.error_codes) {
+	out.push_back(code);
+	out.push_back(static_cast<int64_t>(count));
+    }
+    put(out, summary.retries);
+    out.push_back(static_cast<int64_t>(summary.retried));
+    put(out, summary.retry_latency);
+    out.push_back(static_cast<int64_t>(summary.slots.size()));
+    for(auto &slot: summary.slots) {
+	put(out, slot);
+    }
+}
+
+static void get(const int64_t *&in, call_summary_t &summary)
+{
+    get(in, summary.latency);
+    summary.deadline_met = static_cast<size_t>(*in++);
+    get(in, summary.errors);
+    for(auto codes = *in++; codes > 0; codes--) {
+	auto code = static_cast<int>(*in++);
+	summary.error_codes[code] = static_cast<size_t>(*in++);
+    }
+    get(in, summary.retries);
+    summary.retried = static_cast<size_t>(*in++);
+    get(in, summary.retry_latency);
+    summary.slots.resize(static_cast<size_t>(*in++));
+    for(auto &slot: summary.slots) {
+	get(in, slot);
+    }
+}
+
+
+ProcessGroup::ProcessGroup(size_t processes)
+    : m_processes(processes), m_leader(getpid())
+{
+    void *area = mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(area == MAP_FAILED) {
+	throw ProcessGroupException("cannot allocate shared memory for process group: " + std::string(strerror(errno)));
+    }
+    m_shared = new(area) Shared;
+
+    // don't duplicate buffered output into children
+    std::cout.flush();
+    std::fflush(stdout);
+
+    for(size_t rank=1; rank<m_processes; rank++) {
+	pid_t pid = fork();
+
+	if(pid < 0) {
+	    abort();
+	    throw ProcessGroupException("cannot fork process: " + std::string(strerror(errno)));
+	}
+
+	if(pid == 0) {
+	    m_rank = rank;
+	    m_children.clear();
+	    return;
+	}
+
+	m_children.push_back(pid);
+	m_status.push_back(-1);
+    }
+}
+
+
+ProcessGroup::~ProcessGroup()
+{
+    munmap(m_shared, sizeof(Shared));
+}
+
+
+std::string ProcessGroup::segment(size_t rank, size_t exchange) const
+{
+    return "/p11perftest." + std::to_string(m_leader) + '.' + std::to_string(rank) + '.' + std::to_string(exchange);
+}
+
+
+void ProcessGroup::check()
+{
+    if(leader()) {
+	// a child leaving while others wait for it has failed
+	for(size_t c=0; c<m_children.size(); c++) {
+	    int status;
+	    if(m_status[c] == -1 && waitpid(m_children[c], &status, WNOHANG) == m_children[c]) {
+		m_status[c] = status;
+		m_shared->aborted = true;
+	    }
+	}
+    } else if(getppid() != m_leader) {
+	m_shared->aborted = true;
+    }
+
+    if(m_shared->aborted) {
+	throw ProcessGroupException("a process of the group has failed");
+    }
+}
+
+
+ActiveWindow &ProcessGroup::window()
+{
+    return m_shared->window;
+}
+
+
+void ProcessGroup::sync()
+{
+    auto generation = m_shared->generation.load(std::memory_order_acquire);
+
+    if(m_shared->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == m_processes) {
+	m_shared->arrived.store(0, std::memory_order_relaxed);
+	m_shared->generation.fetch_add(1, std::memory_order_release);
+	return;
+    }
+
+    const auto spin_end = std::chrono::steady_clock::now() + spinning;
+
+    for(size_t polls=0; m_shared->generation.load(std::memory_order_acquire) == generation; ) {
+	if(std::chrono::steady_clock::now() >= spin_end) {
+	    std::this_thread::sleep_for(polling);
+	    // from time to time, check that no process has failed
+	    if(++polls % 50 == 0) {
+		check();
+	    }
+	}
+    }
+}
+
+
+std::vector<benchmark_result_t> ProcessGroup::allgather(const std::vector<benchmark_result_t> &local, std::chrono::steady_clock::time_point epoch, nanosecond_type &wallclock)
+{
+    std::vector<benchmark_result_t> rv;
+
+    // publish our own results: epoch, wall clock, then each thread result
+    std::vector<int64_t> out;
+    out.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(epoch.time_since_epoch()).count());
+    out.push_back(wallclock);
+    out.push_back(static_cast<int64_t>(local.size()));
+    for(auto &result: local) {
+	out.push_back(result.errcode);
+	out.push_back(result.span);
+	out.push_back(result.released);
+	out.push_back(result.started);
+	out.push_back(result.finished);
+	put(out, result.records);
+	put(out, result.queueing);
+	put(out, result.operations);
+	put(out, result.slots);
+	put(out, result.timestamps);
+	put(out, result.warmup);
+	out.push_back(static_cast<int64_t>(result.truncation));
+	out.push_back(result.steady ? 1 : 0);
+	put(out, result.errors);
+	put(out, result.error_timestamps);
+	put(out, result.error_codes);
+	put(out, result.retries);
+	put(out, result.retried);
+	out.push_back(static_cast<int64_t>(result.reopened));
+	out.push_back(result.reopen_time);
+	out.push_back(result.cpu.user);
+	out.push_back(result.cpu.system);
+	out.push_back(result.cpu.oncpu);
+	out.push_back(result.cpu.runqueue);
+	out.push_back(static_cast<int64_t>(result.cpu.voluntary));
+	out.push_back(static_cast<int64_t>(result.cpu.involuntary));
+	out.push_back(static_cast<int64_t>(result.cpu.calls));
+	out.push_back((result.cpu.rusage ? 1 : 0) | (result.cpu.schedstat ? 2 : 0));
+	put(out, result.in_window);
+	put(out, result.outside);
+	out.push_back(result.series.origin);
+	out.push_back(result.series.end);
+	out.push_back(static_cast<int64_t>(result.series.intervals.size()));
+	for(auto &interval: result.series.intervals) {
+	    out.push_back(static_cast<int64_t>(interval.ops));
+	    out.push_back(static_cast<int64_t>(interval.errors));
+	    out.push_back(interval.busy);
+	    out.push_back(interval.max);
+	    out.push_back(static_cast<int64_t>(interval.latency.size()));
+	    for(auto [index, count]: interval.latency) {
+		out.push_back(static_cast<int64_t>(index));
+		out.push_back(static_cast<int64_t>(count));
+	    }
+	}
+    }
+
+    const size_t size = out.size() * sizeof(int64_t);
+    const auto name = segment(m_rank, m_exchange);
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if(fd < 0 || ftruncate(fd, size) != 0) {
+	abort();
+	throw ProcessGroupException("cannot create shared memory segment " + name + ": " + strerror(errno));
+    }
+    void *area = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(area == MAP_FAILED) {
+	abort();
+	throw ProcessGroupException("cannot map shared memory segment " + name + ": " + strerror(errno));
+    }
+    std::memcpy(area, out.data(), size);
+    munmap(area, size);
+
+    sync();			// all results are published
+
+    for(size_t rank=0; rank<m_processes; rank++) {
+	if(rank == m_rank) {
+	    rv.insert(rv.end(), local.begin(), local.end());
+	    continue;
+	}
+
+	const auto peer = segment(rank, m_exchange);
+	struct stat st;
+	fd = shm_open(peer.c_str(), O_RDONLY, 0);
+	if(fd < 0 || fstat(fd, &st) != 0) {
+	    abort();
+	    throw ProcessGroupException("cannot open shared memory segment " + peer + ": " + strerror(errno));
+	}
+	area = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(area == MAP_FAILED) {
+	    abort();
+	    throw ProcessGroupException("cannot map shared memory segment " + peer + ": " + strerror(errno));
+	}
+
+	const int64_t *in = static_cast<const int64_t *>(area);
+	// times are relative to the epoch of each process. the steady clock is shared by all processes,
+	// so we can shift them to our own epoch.
+	const auto shift = *in++ - out[0];
+	wallclock = std::max(wallclock, static_cast<nanosecond_type>(*in++));
+
+	auto count = static_cast<size_t>(*in++);
+	for(size_t th=0; th<count; th++) {
+	    benchmark_result_t result;
+	    result.errcode = static_cast<int>(*in++);
+	    result.span = *in++;
+	    result.released = *in++ + shift;
+	    result.started = *in++ + shift;
+	    result.finished = *in++ + shift;
+	    get(in, result.records);
+	    get(in, result.queueing);
+	    get(in, result.operations);
+	    get(in, result.slots);
+	    get(in, result.timestamps);
+	    for(auto &timestamp: result.timestamps) {
+		timestamp += shift;
+	    }
+	    get(in, result.warmup);
+	    result.truncation = static_cast<size_t>(*in++);
+	    result.steady = *in++ != 0;
+	    get(in, result.errors);
+	    get(in, result.error_timestamps);
+	    for(auto &timestamp: result.error_timestamps) {
+		timestamp += shift;
+	    }
+	    get(in, result.error_codes);
+	    get(in, result.retries);
+	    get(in, result.retried);
+	    result.reopened = static_cast<size_t>(*in++);
+	    result.reopen_time = *in++;
+	    result.cpu.user = *in++;
+	    result.cpu.system = *in++;
+	    result.cpu.oncpu = *in++;
+	    result.cpu.runqueue = *in++;
+	    result.cpu.voluntary = static_cast<size_t>(*in++);
+	    result.cpu.involuntary = static_cast<size_t>(*in++);
+	    result.cpu.calls = static_cast<size_t>(*in++);
+	    result.cpu.rusage = (*in & 1) != 0;
+	    result.cpu.schedstat = (*in++ & 2) != 0;
+	    get(in, result.in_window);
+	    get(in, result.outside);
+	    // intervals are counted from the origin of the run, which is shared: only the origin moves
+	    result.series.origin = *in++ + shift;
+	    result.series.end = *in++ + shift;
+	    result.series.intervals.resize(static_cast<size_t>(*in++));
+	    for(auto &interval: result.series.intervals) {
+		interval.ops = static_cast<size_t>(*in++);
+		interval.errors = static_cast<size_t>(*in++);
+		interval.busy = *in++;
+		interval.max = *in++;
+		interval.latency.resize(static_cast<size_t>(*in++));
+		for(auto &counter: interval.latency) {
+		    counter.first = static_cast<size_t>(*in++);
+		    counter.second = static_cast<std::uint64_t>(*in++);
+		}
+	    }
+	    rv.push_back(std::move(result));
+	}
+
+	munmap(area, st.st_size);
+    }
+
+    sync();			// all results are read, segments can go
+    shm_unlink(name.c_str());
+    m_exchange++;
+
+    return rv;
+}
+
+
+void ProcessGroup::abort()
+{
+    m_shared->aborted = true;
+}
+
+
+bool ProcessGroup::wait()
+{
+    bool rv = true;
+
+    for(size_t c=0; c<m_children.size(); c++) {
+	if(m_status[c] == -1) {
+	    waitpid(m_children[c], &m_status[c], 0);
+	}
+	rv = rv && WIFEXITED(m_status[c]) && WEXITSTATUS(m_status[c]) == 0;
+    }
+
+    return rv;
+}
@@ -0,0 +1,83 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// processgroup.hpp: a group of processes, running the same benchmarks concurrently, and sharing their results
+
+#if !defined(PROCESSGROUP_H)
+#define PROCESSGROUP_H
+
+#include <vector>
+#include <chrono>
+#include <string>
+#include <stdexcept>
+#include <sys/types.h>
+#include "p11benchmark.hpp"
+
+struct ProcessGroupException : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+};
+
+// the leader (rank 0) forks the other processes, before the PKCS#11 library is loaded:
+// each process then initializes the library, logs in and prepares its own keys.
+// processes execute the same sequence of test cases: they start them together,
+// and exchange their results through shared memory, so that all of them compute the same statistics.
+class ProcessGroup
+{
+    struct Shared;		// control block, in memory shared by all processes
+
+    Shared *m_shared { nullptr };
+    size_t m_processes;
+    size_t m_rank { 0 };
+    pid_t m_leader;
+    std::vector<pid_t> m_children; // leader only
+    std::vector<int> m_status;	   // leader only: exit status of children, once reaped
+    size_t m_exchange { 0 };	   // number of results exchanged so far
+
+    std::string segment(size_t rank, size_t exchange) const;
+    void check();		// throw if a process of the group has failed
+
+public:
+    // fork processes-1 processes. The calling process is the leader.
+    ProcessGroup(size_t processes);
+    ~ProcessGroup();
+
+    ProcessGroup( const ProcessGroup &) = delete;
+    ProcessGroup& operator=( const ProcessGroup &) = delete;
+
+    inline size_t size() const { return m_processes; }
+    inline size_t rank() const { return m_rank; }
+    inline bool leader() const { return m_rank == 0; }
+
+    // window(): the active window shared by all threads of all processes, see ActiveWindow
+    ActiveWindow &window();
+
+    // sync(): wait until all processes of the group have reached this point
+    void sync();
+
+    // allgather(): share results of this process with the others, and return the results of all processes, by rank.
+    // times relative to epoch are shifted to the epoch of this process. The wall clock is the longest of all.
+    std::vector<benchmark_result_t> allgather(const std::vector<benchmark_result_t> &local, std::chrono::steady_clock::time_point epoch, nanosecond_type &wallclock);
+
+    // abort(): tell other processes that this one is failing, so they don't wait for it
+    void abort();
+
+    // wait(): leader only, wait for other processes to exit. returns false if any of them has failed
+    bool wait();
+};
+
+#endif // PROCESSGROUP_H
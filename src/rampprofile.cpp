@@ -0,0 +1,78 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// rampprofile.cpp: a class to describe a step load profile, e.g. "1:64:8:10s"
+
+#include <cstdlib>
+#include <boost/tokenizer.hpp>
+#include "rampprofile.hpp"
+#include "duration.hpp"
+
+RampProfile::RampProfile(std::string spec)
+{
+    boost::char_separator<char> sep(":");
+    boost::tokenizer<boost::char_separator<char>> toparse(spec, sep);
+    std::vector<std::string> tokens(toparse.begin(), toparse.end());
+
+    if(tokens.size() != 4) {
+	throw RampProfileException("ramp must be given as start:max:increment:interval, got " + spec);
+    }
+
+    auto to_size = [&spec] (const std::string &token) -> size_t {
+		       char *end = nullptr;
+		       auto value = strtol(token.c_str(), &end, 10);
+		       if(*end != '\0' || value <= 0) {
+			   throw RampProfileException("invalid number of threads in ramp " + spec);
+		       }
+		       return static_cast<size_t>(value);
+		   };
+
+    m_start = to_size(tokens[0]);
+    m_max = to_size(tokens[1]);
+    m_increment = to_size(tokens[2]);
+
+    try {
+	m_interval = parse_duration(tokens[3]);
+    } catch (DurationException &e) {
+	throw RampProfileException(std::string("invalid interval in ramp: ") + e.what());
+    }
+
+    if(m_start > m_max) {
+	throw RampProfileException("ramp starts above its maximum number of threads: " + spec);
+    }
+
+    if(m_interval.count() == 0) {
+	throw RampProfileException("ramp interval must be greater than zero: " + spec);
+    }
+}
+
+
+std::vector<size_t> RampProfile::steps() const
+{
+    std::vector<size_t> rv;
+
+    for(size_t active = m_start; ; active += m_increment) {
+	if(active >= m_max) {
+	    rv.push_back(m_max); // the last step is capped to the maximum
+	    break;
+	}
+	rv.push_back(active);
+    }
+
+    return rv;
+}
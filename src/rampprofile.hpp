@@ -0,0 +1,56 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// rampprofile.hpp: a class to describe a step load profile, e.g. "1:64:8:10s"
+
+#if !defined(RAMPPROFILE_H)
+#define RAMPPROFILE_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+struct RampProfileException : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+};
+
+// a ramp starts with a number of active threads, and adds a number of threads
+// at every step, until the maximum number of threads is reached.
+// the specification is given as "start:max:increment:interval", e.g. "1:64:8:10s"
+class RampProfile
+{
+    size_t m_start;
+    size_t m_max;
+    size_t m_increment;
+    std::chrono::nanoseconds m_interval;
+
+public:
+    RampProfile(std::string spec);
+
+    inline size_t maxthreads() const { return m_max; }
+    inline std::chrono::nanoseconds interval() const { return m_interval; }
+
+    // steps(): returns the number of active threads, for each step
+    std::vector<size_t> steps() const;
+
+    // duration(): returns the total duration of the ramp
+    inline std::chrono::nanoseconds duration() const { return m_interval * steps().size(); }
+};
+
+#endif // RAMPPROFILE_H
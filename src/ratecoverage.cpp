@@ -0,0 +1,52 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// ratecoverage.cpp: a class to select offered rates to sweep, in open loop mode
+
+#include <set>
+#include <string>
+#include <cstdlib>
+#include <boost/tokenizer.hpp>
+#include "ratecoverage.hpp"
+
+template <>
+SetWrapper<double>::SetWrapper(std::string tocover)
+{
+    // rates may have decimals, we only split on commas
+    boost::char_separator<char> sep(",");
+    boost::tokenizer<boost::char_separator<char>> toparse(tocover, sep);
+
+    for(auto token : toparse) {
+	auto rate = strtod(token.c_str(),nullptr);
+	if(rate > 0.0) {
+	    m_vector_coverage.insert(rate);
+	}
+    }
+}
+
+template <>
+bool SetWrapper<double>::contains(double rate)
+{
+    return m_vector_coverage.find(rate) != m_vector_coverage.end();
+}
+
+template <>
+bool SetWrapper<double>::contains(std::string rate)
+{
+    return contains(strtod(rate.c_str(),nullptr));
+}
@@ -0,0 +1,30 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// ratecoverage.hpp: a class to select offered rates to sweep, in open loop mode
+
+#if !defined(RATECOVERAGE_H)
+#define RATECOVERAGE_H
+
+#include <set>
+#include <string>
+#include "vectorcoverage.hpp"
+
+using RateCoverage = SetWrapper<double>;
+
+#endif // RATECOVERAGE_H
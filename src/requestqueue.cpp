@@ -0,0 +1,114 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// requestqueue.cpp: a queue of requests issued by logical clients, and served by carrier threads
+
+#include "requestqueue.hpp"
+
+
+void RequestQueue::reset(size_t clients, size_t inflight, size_t iterations, std::chrono::nanoseconds duration)
+{
+    std::lock_guard<std::mutex> lck(m_mtx);
+    m_queue.clear();
+    m_clients = clients;
+    m_inflight = inflight;
+    m_toissue = clients * iterations;
+    m_outstanding = 0;
+    m_duration = duration;
+    m_open = false;
+}
+
+
+void RequestQueue::open(std::chrono::steady_clock::time_point start)
+{
+    {
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_deadline = start + m_duration;
+	m_open = true;
+
+	// clients are interleaved, so that they are served fairly from the start
+	for(size_t slot=0; slot<m_inflight; slot++) {
+	    for(size_t client=0; client<m_clients; client++) {
+		if(m_duration.count() == 0) {
+		    if(m_toissue == 0) {
+			break;
+		    }
+		    m_toissue--;
+		}
+		m_queue.push_back( Request { client, start } );
+		m_outstanding++;
+	    }
+	}
+    }
+    m_cond.notify_all();
+}
+
+
+std::optional<Request> RequestQueue::pop()
+{
+    std::unique_lock<std::mutex> lck(m_mtx);
+
+    // before open(), there is nothing outstanding yet: we wait for requests.
+    m_cond.wait(lck, [this] { return !m_queue.empty() || (m_open && m_outstanding == 0); });
+
+    if(m_queue.empty()) {
+	return std::nullopt;	// all requests have completed
+    }
+
+    auto request = m_queue.front();
+    m_queue.pop_front();
+    return request;
+}
+
+
+void RequestQueue::complete(const Request &request)
+{
+    {
+	std::lock_guard<std::mutex> lck(m_mtx);
+	auto now = std::chrono::steady_clock::now();
+	bool more = false;
+
+	if(m_duration.count() > 0) {
+	    more = now < m_deadline;
+	} else if(m_toissue > 0) {
+	    m_toissue--;
+	    more = true;
+	}
+
+	if(more) {
+	    // the client issues its next request right away
+	    m_queue.push_back( Request { request.client, now } );
+	} else {
+	    m_outstanding--;
+	}
+    }
+    m_cond.notify_all();
+}
+
+
+void RequestQueue::abort()
+{
+    {
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_toissue = 0;
+	m_duration = std::chrono::nanoseconds(0);
+	m_outstanding -= m_queue.size() + 1; // pending requests, and the failed one
+	m_queue.clear();
+    }
+    m_cond.notify_all();
+}
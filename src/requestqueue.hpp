@@ -0,0 +1,78 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// requestqueue.hpp: a queue of requests issued by logical clients, and served by carrier threads
+
+#if !defined(REQUESTQUEUE_H)
+#define REQUESTQUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <optional>
+
+// Request: an operation issued by a logical client
+struct Request {
+    size_t client;					// logical client index
+    std::chrono::steady_clock::time_point submitted;	// when the request was issued
+};
+
+// RequestQueue: each logical client keeps a number of requests in flight.
+// when a request completes, the client immediately issues a new one, until the run is over.
+// Requests are served in FIFO order, by carrier threads.
+class RequestQueue
+{
+    std::mutex m_mtx;
+    std::condition_variable m_cond;
+    std::deque<Request> m_queue;
+    size_t m_clients { 0 };
+    size_t m_inflight { 0 };
+    size_t m_toissue { 0 };	// fixed iterations: number of requests still to issue, for all clients
+    size_t m_outstanding { 0 };	// number of requests issued and not yet completed
+    std::chrono::nanoseconds m_duration { 0 }; // duration-based runs: no request is issued past start + duration
+    std::chrono::steady_clock::time_point m_deadline;
+    bool m_open { false };	// true once initial requests are issued
+
+public:
+    RequestQueue() = default;
+
+    RequestQueue( const RequestQueue &) = delete;
+    RequestQueue& operator=( const RequestQueue &) = delete;
+
+    // reset(): prepare a run, where each client issues either a fixed number of requests,
+    // or, if duration is not null, requests until the duration has elapsed.
+    void reset(size_t clients, size_t inflight, size_t iterations, std::chrono::nanoseconds duration);
+
+    // open(): issue the initial requests, inflight per client
+    void open(std::chrono::steady_clock::time_point start);
+
+    // pop(): wait for the next request. returns std::nullopt once all requests have completed
+    std::optional<Request> pop();
+
+    // complete(): tell a request is completed; its client may issue a new one
+    void complete(const Request &request);
+
+    // abort(): tell a popped request has failed. no more request is issued, and pending ones are dropped
+    void abort();
+
+    inline size_t clients() const { return m_clients; }
+    inline size_t inflight() const { return m_inflight; }
+};
+
+#endif // REQUESTQUEUE_H
@@ -0,0 +1,110 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// retrypolicy.cpp: a class to describe how failed calls are retried, e.g. "exp:1ms:5"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <boost/tokenizer.hpp>
+#include <botan/p11.h>
+#include "retrypolicy.hpp"
+#include "errorcodes.hpp"
+#include "duration.hpp"
+
+RetryPolicy::RetryPolicy(const std::string &spec, const std::string &codes)
+{
+    boost::char_separator<char> sep(":");
+    boost::tokenizer<boost::char_separator<char>> toparse(spec, sep);
+    std::vector<std::string> tokens(toparse.begin(), toparse.end());
+    size_t delayed = 1;		// how many tokens before the number of retries
+
+    if((tokens.size() == 2 || tokens.size() == 3) && tokens[0] == "fixed") {
+	m_model = Model::fixed;
+	delayed = 2;
+    } else if((tokens.size() == 2 || tokens.size() == 3) && tokens[0] == "exp") {
+	m_model = Model::exponential;
+	delayed = 2;
+    } else if((tokens.size() == 1 || tokens.size() == 2) && tokens[0] == "reopen") {
+	m_model = Model::reopen;
+    } else {
+	throw RetryPolicyException("retry policy must be given as fixed:<delay>[:<retries>], exp:<delay>[:<retries>] or reopen[:<retries>], got " + spec);
+    }
+
+    if(delayed == 2) {
+	try {
+	    m_delay = parse_duration(tokens[1]);
+	} catch (DurationException &e) {
+	    throw RetryPolicyException(std::string("invalid delay in retry policy: ") + e.what());
+	}
+	if(m_delay.count() == 0 && m_model == Model::exponential) {
+	    throw RetryPolicyException("exponential backoff delay must be greater than zero: " + spec);
+	}
+    }
+
+    if(tokens.size() > delayed) {
+	char *end = nullptr;
+	auto retries = strtol(tokens[delayed].c_str(), &end, 10);
+	if(*end != '\0' || retries < 1) {
+	    throw RetryPolicyException("invalid number of retries in retry policy " + spec);
+	}
+	m_retries = static_cast<size_t>(retries);
+    }
+
+    boost::char_separator<char> comma(",");
+    boost::tokenizer<boost::char_separator<char>> codelist(codes, comma);
+
+    for(auto &code: codelist) {
+	auto rc = errorcode_value(code);
+	if(!rc) {
+	    throw RetryPolicyException("unknown return code " + code);
+	}
+	m_codes.insert(*rc);
+    }
+
+    if(m_codes.empty()) {
+	throw RetryPolicyException("no return code to retry on");
+    }
+
+    m_spec = spec + " on " + codes;
+}
+
+
+bool RetryPolicy::reopens(int rc)
+{
+    return rc == CKR_SESSION_HANDLE_INVALID || rc == CKR_SESSION_CLOSED;
+}
+
+
+std::chrono::nanoseconds RetryPolicy::backoff(size_t k, std::mt19937 &generator) const
+{
+    switch(m_model) {
+    case Model::fixed:
+	return m_delay;
+
+    case Model::exponential: {
+	// full jitter: clients failing together do not retry together
+	auto ceiling = static_cast<double>(m_delay.count()) * std::pow(2.0, static_cast<double>(k));
+	auto ns = std::uniform_real_distribution<double>(0.0, ceiling)(generator);
+	return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(ns));
+    }
+
+    default:
+	return std::chrono::nanoseconds(0);
+    }
+}
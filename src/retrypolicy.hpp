@@ -0,0 +1,82 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// retrypolicy.hpp: a class to describe how failed calls are retried, e.g. "exp:1ms:5"
+
+#if !defined(RETRYPOLICY_H)
+#define RETRYPOLICY_H
+
+#include <chrono>
+#include <string>
+#include <set>
+#include <random>
+#include <stdexcept>
+
+struct RetryPolicyException : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+};
+
+// a lost session was reopened, but the test case could not be prepared again on it. rc is the return code of the lost call
+struct ReopenException : std::runtime_error {
+    const int rc;
+    ReopenException(const std::string &what, int rc) : std::runtime_error(what), rc(rc) { }
+};
+
+// the retry policy is given as:
+// - "fixed:<delay>[:<retries>]" : wait the same delay before each retry
+// - "exp:<delay>[:<retries>]"   : exponential backoff with full jitter: before retry k (from 0),
+//				   wait a random time between 0 and delay*2^k
+// - "reopen[:<retries>]"	 : retry at once
+// retries is the maximum number of retries of a call (3 by default), and delays accept the same units as --duration.
+// Only calls failing with one of the given return codes are retried. With all policies, when the return code tells
+// that the session is gone (CKR_SESSION_HANDLE_INVALID or CKR_SESSION_CLOSED), a new session is opened and logged in
+// before retrying, and the key is looked up again on it (see P11Benchmark::execute()).
+class RetryPolicy
+{
+public:
+    enum class Model { none, fixed, exponential, reopen };
+
+private:
+    Model m_model { Model::none };
+    std::chrono::nanoseconds m_delay { 0 };
+    size_t m_retries { 3 };
+    std::set<int> m_codes;	// return codes for which calls are retried
+    std::string m_spec { "none" };
+
+public:
+    RetryPolicy() = default;	// no retry
+    RetryPolicy(const std::string &spec, const std::string &codes);
+
+    inline bool enabled() const { return m_model != Model::none; }
+
+    // retries(): the maximum number of retries of a call
+    inline size_t retries() const { return m_retries; }
+
+    // retryable(): tells if a call failing with return code rc is retried
+    inline bool retryable(int rc) const { return m_codes.count(rc) > 0; }
+
+    // reopens(): tells if return code rc requires a new session
+    static bool reopens(int rc);
+
+    // backoff(): how long to wait before retry k (from 0)
+    std::chrono::nanoseconds backoff(size_t k, std::mt19937 &generator) const;
+
+    inline const std::string &to_string() const { return m_spec; }
+};
+
+#endif // RETRYPOLICY_H
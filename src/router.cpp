@@ -0,0 +1,163 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// router.cpp: a class to route calls accross several slots (tokens), following a policy
+
+#include <limits>
+#include "router.hpp"
+
+// weight of the last call in latency moving averages
+static constexpr double smoothing = 0.1;
+
+Router::Router(const std::string &policy, const std::vector<int> &slots)
+    : m_slots(slots),
+      m_outstanding(new std::atomic<long>[slots.size()]),
+      m_latency(new std::atomic<double>[slots.size()])
+{
+    if(policy == "round-robin") {
+	m_policy = Policy::roundrobin;
+    } else if(policy == "least-outstanding") {
+	m_policy = Policy::leastoutstanding;
+    } else if(policy == "power-of-two") {
+	m_policy = Policy::poweroftwo;
+    } else if(policy == "latency-weighted") {
+	m_policy = Policy::latencyweighted;
+    } else {
+	throw RouterException("unknown routing policy: " + policy);
+    }
+
+    if(m_slots.empty()) {
+	throw RouterException("at least one slot is needed for routing");
+    }
+
+    reset();
+}
+
+
+void Router::reset()
+{
+    m_next = 0;
+    for(size_t s=0; s<m_slots.size(); s++) {
+	m_outstanding[s] = 0;
+	m_latency[s] = 0.0;
+    }
+}
+
+
+std::string Router::policy() const
+{
+    switch(m_policy) {
+    case Policy::leastoutstanding:
+	return "least-outstanding";
+
+    case Policy::poweroftwo:
+	return "power-of-two";
+
+    case Policy::latencyweighted:
+	return "latency-weighted";
+
+    default:
+	return "round-robin";
+    }
+}
+
+
+size_t Router::route(std::mt19937 &generator)
+{
+    const size_t n = m_slots.size();
+    size_t rv = 0;
+
+    switch(m_policy) {
+    case Policy::roundrobin:
+	rv = m_next++ % n;
+	break;
+
+    case Policy::leastoutstanding: {
+	// ties are broken by rotating the first slot considered
+	auto first = m_next++;
+	long fewest = std::numeric_limits<long>::max();
+	for(size_t k=0; k<n; k++) {
+	    auto s = (first + k) % n;
+	    auto outstanding = m_outstanding[s].load();
+	    if(outstanding < fewest) {
+		fewest = outstanding;
+		rv = s;
+	    }
+	}
+	break;
+    }
+
+    case Policy::poweroftwo: {
+	rv = std::uniform_int_distribution<size_t>(0, n-1)(generator);
+	if(n > 1) {
+	    // draw a second slot, distinct from the first one
+	    auto other = (rv + std::uniform_int_distribution<size_t>(1, n-1)(generator)) % n;
+	    if(m_outstanding[other].load() < m_outstanding[rv].load()) {
+		rv = other;
+	    }
+	}
+	break;
+    }
+
+    case Policy::latencyweighted: {
+	// slots with no latency known yet are tried first
+	double total = 0.0;
+	for(size_t s=0; s<n; s++) {
+	    auto latency = m_latency[s].load();
+	    if(latency <= 0.0) {
+		rv = s;
+		total = 0.0;
+		break;
+	    }
+	    total += 1.0 / latency;
+	}
+
+	if(total > 0.0) {
+	    auto draw = std::uniform_real_distribution<double>(0.0, total)(generator);
+	    for(rv=0; rv<n-1; rv++) {
+		draw -= 1.0 / m_latency[rv].load();
+		if(draw < 0.0) {
+		    break;
+		}
+	    }
+	}
+	break;
+    }
+    }
+
+    m_outstanding[rv]++;
+    return rv;
+}
+
+
+void Router::complete(size_t slot, double latency)
+{
+    m_outstanding[slot]--;
+
+    auto average = m_latency[slot].load();
+    double updated;
+    do {
+	updated = average > 0.0 ? average + smoothing * (latency - average) : latency;
+    } while(!m_latency[slot].compare_exchange_weak(average, updated));
+}
+
+
+void Router::abandon(size_t slot)
+{
+    m_outstanding[slot]--;
+}
@@ -0,0 +1,97 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// router.hpp: a class to route calls accross several slots (tokens), following a policy
+
+#if !defined(ROUTER_H)
+#define ROUTER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <random>
+#include <stdexcept>
+
+struct RouterException : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+};
+
+// the router is shared by all threads. Policies are:
+// - round-robin	: slots are used one after the other
+// - least-outstanding	: the slot with the fewest calls in progress is used
+// - power-of-two	: two slots are drawn at random, the one with the fewest calls in progress is used
+// - latency-weighted	: slots are drawn at random, with a weight inversely proportional to their recent latency
+class Router
+{
+public:
+    enum class Policy { roundrobin, leastoutstanding, poweroftwo, latencyweighted };
+
+    // Call: a call routed to a slot, outstanding for the lifetime of the object, unless completed before.
+    // a call that throws is thus never left outstanding. Nothing is done without a router.
+    class Call {
+	Router *m_router;
+	size_t m_slot;
+	bool m_completed { false };
+
+    public:
+	Call(Router *router, size_t slot) : m_router(router), m_slot(slot) { }
+	~Call() { if(m_router && !m_completed) m_router->abandon(m_slot); }
+
+	Call( const Call &) = delete;
+	Call& operator=( const Call &) = delete;
+
+	inline void complete(double latency) {
+	    if(m_router) {
+		m_router->complete(m_slot, latency);
+		m_completed = true;
+	    }
+	}
+    };
+
+private:
+    Policy m_policy;
+    std::vector<int> m_slots;				// slot indices, as given on the command line
+    std::atomic<size_t> m_next { 0 };			// round-robin counter
+    std::unique_ptr<std::atomic<long>[]> m_outstanding;	// calls in progress, per slot
+    std::unique_ptr<std::atomic<double>[]> m_latency;	// moving average of latency, per slot, in ns (0 if unknown)
+
+public:
+    Router(const std::string &policy, const std::vector<int> &slots);
+
+    Router( const Router &) = delete;
+    Router& operator=( const Router &) = delete;
+
+    // reset(): forget about outstanding calls and latency, e.g. between test cases
+    void reset();
+
+    inline size_t slots() const { return m_slots.size(); }
+    inline int slot(size_t s) const { return m_slots.at(s); }
+    std::string policy() const;
+
+    // route(): choose the slot for the next call, and count the call as outstanding, until complete() or abandon(), see Call
+    size_t route(std::mt19937 &generator);
+
+    // complete(): a call on a slot is over, taking latency ns
+    void complete(size_t slot, double latency);
+
+    // abandon(): a call on a slot is over, but its latency is unknown, e.g. it threw
+    void abandon(size_t slot);
+};
+
+#endif // ROUTER_H
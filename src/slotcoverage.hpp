@@ -0,0 +1,31 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// slotcoverage.hpp: a class to select the slots to route calls to
+
+#if !defined(SLOTCOVERAGE_H)
+#define SLOTCOVERAGE_H
+
+#include <set>
+#include <string>
+#include "vectorcoverage.hpp"
+
+// slot indices are parsed like vector sizes
+using SlotCoverage = SetWrapper<std::uint32_t>;
+
+#endif // SLOTCOVERAGE_H
@@ -0,0 +1,92 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// thinktime.cpp: a class to describe the think time of a thread between two calls, e.g. "exp:5ms"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <boost/tokenizer.hpp>
+#include "thinktime.hpp"
+#include "duration.hpp"
+
+ThinkTime::ThinkTime(const std::string &spec)
+    : m_spec(spec)
+{
+    boost::char_separator<char> sep(":");
+    boost::tokenizer<boost::char_separator<char>> toparse(spec, sep);
+    std::vector<std::string> tokens(toparse.begin(), toparse.end());
+
+    if(tokens.size() == 2 && tokens[0] == "fixed") {
+	m_model = Model::fixed;
+    } else if(tokens.size() == 2 && tokens[0] == "exp") {
+	m_model = Model::exponential;
+    } else if(tokens.size() == 3 && tokens[0] == "lognormal") {
+	m_model = Model::lognormal;
+
+	char *end = nullptr;
+	m_sigma = strtod(tokens[2].c_str(), &end);
+	if(*end != '\0' || !(m_sigma > 0.0)) {
+	    throw ThinkTimeException("invalid lognormal shape in think time " + spec);
+	}
+    } else {
+	throw ThinkTimeException("think time must be given as fixed:<time>, exp:<mean> or lognormal:<median>:<sigma>, got " + spec);
+    }
+
+    try {
+	m_time = parse_duration(tokens[1]);
+    } catch (DurationException &e) {
+	throw ThinkTimeException(std::string("invalid time in think time: ") + e.what());
+    }
+
+    if(m_time.count() == 0 && m_model != Model::fixed) {
+	throw ThinkTimeException("think time must be greater than zero: " + spec);
+    }
+}
+
+
+std::chrono::nanoseconds ThinkTime::mean() const
+{
+    if(m_model == Model::lognormal) {
+	// mean of a lognormal distribution, given its median
+	return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(m_time.count() * std::exp(m_sigma * m_sigma / 2)));
+    }
+
+    return m_time;
+}
+
+
+std::chrono::nanoseconds ThinkTime::draw(std::mt19937 &generator) const
+{
+    double ns;
+
+    switch(m_model) {
+    case Model::exponential:
+	ns = std::exponential_distribution<double>(1.0 / m_time.count())(generator);
+	break;
+
+    case Model::lognormal:
+	ns = std::lognormal_distribution<double>(std::log(static_cast<double>(m_time.count())), m_sigma)(generator);
+	break;
+
+    default:
+	return m_time;
+    }
+
+    return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(ns));
+}
@@ -0,0 +1,64 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// thinktime.hpp: a class to describe the think time of a thread between two calls, e.g. "exp:5ms"
+
+#if !defined(THINKTIME_H)
+#define THINKTIME_H
+
+#include <chrono>
+#include <string>
+#include <random>
+#include <stdexcept>
+
+struct ThinkTimeException : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+};
+
+// think time is drawn from a distribution, given as:
+// - "fixed:<time>"	      : always the same time
+// - "exp:<mean>"	      : exponential distribution, i.e. each thread issues calls as a Poisson process
+// - "lognormal:<median>:<sigma>" : lognormal distribution, where sigma is the standard deviation of the log of the time
+// times accept the same units as --duration, e.g. "lognormal:4ms:0.6"
+class ThinkTime
+{
+public:
+    enum class Model { none, fixed, exponential, lognormal };
+
+private:
+    Model m_model { Model::none };
+    std::chrono::nanoseconds m_time { 0 }; // fixed time, mean (exponential) or median (lognormal)
+    double m_sigma { 0.0 };		   // lognormal only: shape parameter
+    std::string m_spec { "none" };
+
+public:
+    ThinkTime() = default;	// no think time
+    ThinkTime(const std::string &spec);
+
+    inline bool enabled() const { return m_model != Model::none; }
+
+    // mean(): the expected think time
+    std::chrono::nanoseconds mean() const;
+
+    // draw(): draw a think time from the distribution
+    std::chrono::nanoseconds draw(std::mt19937 &generator) const;
+
+    inline const std::string &to_string() const { return m_spec; }
+};
+
+#endif // THINKTIME_H
@@ -27,6 +27,7 @@
 
 
 #include "timeprecision.hpp"
+#include "calltimer.hpp"
 
 #include <chrono>
 #include <cmath>
@@ -44,20 +45,21 @@ using namespace boost::accumulators;
 
 // reference: https://www.statsdirect.com/help/basic_descriptive_statistics/standard_deviation.htm
 // returned time is in ns
+// the clock is the one used to time calls (see CallTimer): when it ticks faster than it can be read,
+// e.g. the time stamp counter, the precision is the time taken to read it.
 // TODO: using litterals for setting units
 
 pair<double, double> measure_clock_precision(int iter)
 {
-    using clock = std::chrono::high_resolution_clock;
     accumulator_set<double, stats<tag::mean, tag::variance, tag::count> > te;
 
     for (int i = 0; i < iter; ++i) {
-        auto start = clock::now();
+        auto start = CallTimer::now();
         auto current = start;
         while (current == start) {
-            current = clock::now();
+            current = CallTimer::now();
         }
-        const auto delta = std::chrono::duration_cast<std::chrono::nanoseconds>(current - start).count();
+        const auto delta = CallTimer::to_ns(current - start);
         te(static_cast<double>(delta));
     }
 
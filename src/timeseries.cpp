@@ -0,0 +1,87 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// timeseries.cpp: sampling of calls per interval of a time series, while threads run
+
+#include <algorithm>
+#include "timeseries.hpp"
+
+
+void interval_sample_t::merge(const interval_sample_t &other)
+{
+    ops += other.ops;
+    errors += other.errors;
+    busy += other.busy;
+    // counters of the same sub-bucket add up when the histogram is rebuilt, see LatencyHistogram::from_sparse()
+    latency.insert(latency.end(), other.latency.begin(), other.latency.end());
+    max = std::max(max, other.max);
+}
+
+
+IntervalSampler::IntervalSampler(sampled_series_t &series, std::chrono::nanoseconds length)
+    : m_series(series), m_length(length.count())
+{ }
+
+
+void IntervalSampler::start(nanosecond_type origin)
+{
+    m_series.origin = m_series.end = m_previous = origin;
+}
+
+
+void IntervalSampler::flush()
+{
+    if(m_current.count() > 0 && !m_series.intervals.empty()) {
+	m_series.intervals.back().latency = m_current.sparse();
+	m_series.intervals.back().max = m_current.max();
+	m_current.clear();
+    }
+}
+
+
+void IntervalSampler::sample(nanosecond_type completed, nanosecond_type latency, bool ok)
+{
+    if(!enabled()) {
+	return;
+    }
+
+    // calls of a thread complete in order: a call past the last interval ends it
+    auto i = index(completed);
+    if(i >= m_series.intervals.size()) {
+	flush();
+	m_series.intervals.resize(i + 1);
+    }
+
+    if(ok) {
+	m_series.intervals[i].ops++;
+	m_current.record(latency);
+    } else {
+	m_series.intervals[i].errors++;
+    }
+
+    // spread the time spent in the call over the intervals it covers
+    auto from = std::max({ completed - latency, m_previous, m_series.origin });
+    for(auto t = from; t < completed; ) {
+	auto j = index(t);
+	auto until = std::min(completed, m_series.origin + static_cast<nanosecond_type>(j + 1) * m_length);
+	m_series.intervals[j].busy += until - t;
+	t = until;
+    }
+
+    m_series.end = m_previous = completed;
+}
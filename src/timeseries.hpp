@@ -0,0 +1,88 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// timeseries.hpp: sampling of calls per interval of a time series, while threads run
+
+#if !defined(TIMESERIES_H)
+#define TIMESERIES_H
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <boost/timer/timer.hpp>
+#include "histogram.hpp"
+
+using boost::timer::nanosecond_type;
+
+// interval_sample_t: what a thread did during an interval of a time series
+struct interval_sample_t {
+    size_t ops { 0 };		// number of calls completed successfully
+    size_t errors { 0 };	// number of calls failed, when errors are tolerated
+    nanosecond_type busy { 0 };	// time spent in calls during the interval
+    std::vector<std::pair<size_t, std::uint64_t> > latency; // latency of calls completed successfully, as histogram counters
+    std::int64_t max { 0 };	// highest latency counted
+
+    // merge(): add what happened during the same interval, on another thread or chunk
+    void merge(const interval_sample_t &other);
+};
+
+// sampled_series_t: the calls of a thread, sampled per interval
+struct sampled_series_t {
+    nanosecond_type origin { 0 }; // start of the first interval, since start
+    nanosecond_type end { 0 };	  // completion of the last call sampled, since start
+    std::vector<interval_sample_t> intervals;
+};
+
+// IntervalSampler counts the calls of a thread in the intervals of a time series, as they complete.
+// Intervals start at the origin of the run, shared by all threads (see ActiveWindow), so that the series
+// of threads can be merged interval by interval. Latency is counted in a histogram while the interval is
+// in progress, and kept as sparse counters once it is over: memory grows with the number of intervals,
+// not with the number of calls. The last interval is flushed when the sampler goes.
+class IntervalSampler
+{
+    sampled_series_t &m_series;
+    const nanosecond_type m_length;
+    nanosecond_type m_previous { 0 }; // completion of the previous call
+    LatencyHistogram m_current;	      // latency of calls completed during the last interval
+
+    inline size_t index(nanosecond_type t) const {
+	return t <= m_series.origin ? 0 : static_cast<size_t>((t - m_series.origin) / m_length);
+    }
+
+    void flush();
+
+public:
+    IntervalSampler(sampled_series_t &series, std::chrono::nanoseconds length);
+    ~IntervalSampler() { flush(); }
+
+    IntervalSampler(const IntervalSampler &) = delete;
+    IntervalSampler& operator=(const IntervalSampler &) = delete;
+
+    inline bool enabled() const { return m_length > 0; }
+
+    // start(): intervals start at origin, since start
+    void start(nanosecond_type origin);
+
+    // sample(): count a call that completed at a time since start, after latency. Successful calls only count
+    // towards the latency. A call occupies the thread for its latency before it completed, but no earlier than
+    // the completion of the previous call (in open loop, latency includes the delay with which the call started).
+    void sample(nanosecond_type completed, nanosecond_type latency, bool ok);
+};
+
+#endif // TIMESERIES_H
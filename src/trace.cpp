@@ -0,0 +1,219 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// trace.cpp: a binary trace of every PKCS#11 call, written in the background
+
+#include <algorithm>
+#include "trace.hpp"
+
+// the ring of the current worker thread, set by bind()
+static thread_local Trace::Ring *current_ring = nullptr;
+
+// put(): append an integer of n bytes, little-endian
+static void put(std::vector<std::uint8_t> &out, std::uint64_t value, size_t n)
+{
+    for(size_t i=0; i<n; i++) {
+	out.push_back(static_cast<std::uint8_t>(value >> (8*i)));
+    }
+}
+
+// put_varint(): append an integer, 7 bits per byte, least significant first
+static void put_varint(std::vector<std::uint8_t> &out, std::uint64_t value)
+{
+    while(value >= 0x80) {
+	out.push_back(static_cast<std::uint8_t>(value | 0x80));
+	value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+// zigzag(): map signed integers to unsigned ones, small in absolute value to small
+static inline std::uint64_t zigzag(std::int64_t value)
+{
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+
+void Trace::Ring::drain(std::vector<trace_record_t> &out)
+{
+    auto tail = m_tail.load(std::memory_order_relaxed);
+    auto head = m_head.load(std::memory_order_acquire);
+
+    for(; tail != head; tail++) {
+	out.push_back(m_records[tail & (capacity - 1)]);
+    }
+    m_tail.store(tail, std::memory_order_release);
+}
+
+
+Trace::Trace(const std::string &path, size_t rank)
+    : m_path(path),
+      m_file(path, std::ios::binary | std::ios::trunc)
+{
+    if(!m_file) {
+	throw TraceException("cannot open trace file " + path);
+    }
+
+    // origin of the trace, on both clocks, so that readers can convert times to wall clock
+    m_origin = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    auto realtime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::vector<std::uint8_t> header(tracefile::magic, tracefile::magic + sizeof(tracefile::magic));
+    put(header, tracefile::version, 4);
+    put(header, rank, 4);
+    put(header, static_cast<std::uint64_t>(m_origin), 8);
+    put(header, static_cast<std::uint64_t>(realtime), 8);
+    m_file.write(reinterpret_cast<const char *>(header.data()), header.size());
+
+    m_thread = std::thread(&Trace::loop, this);
+}
+
+
+Trace::~Trace()
+{
+    close();
+}
+
+
+void Trace::bind(size_t worker, const std::string &arm)
+{
+    std::lock_guard<std::mutex> lck(m_mtx);
+    m_rings.push_back(std::make_unique<Ring>(*this, worker, arm));
+    current_ring = m_rings.back().get();
+}
+
+
+Trace::Ring *Trace::current()
+{
+    return current_ring;
+}
+
+
+std::uint32_t Trace::testcase(const std::string &name, size_t vector)
+{
+    std::lock_guard<std::mutex> lck(m_mtx);
+    auto key = std::make_pair(name, vector);
+    auto it = m_testcases.find(key);
+
+    if(it == m_testcases.end()) {
+	auto id = static_cast<std::uint32_t>(m_testcases.size());
+	it = m_testcases.emplace(key, id).first;
+
+	// written by the collector, before any record referring to it
+	m_pending.push_back(static_cast<std::uint8_t>(tracefile::Chunk::testcase));
+	put(m_pending, id, 4);
+	put(m_pending, vector, 4);
+	put(m_pending, name.size(), 4);
+	m_pending.insert(m_pending.end(), name.begin(), name.end());
+    }
+
+    return it->second;
+}
+
+
+size_t Trace::dropped()
+{
+    std::lock_guard<std::mutex> lck(m_mtx);
+    size_t rv = 0;
+
+    for(auto &ring: m_rings) {
+	rv += ring->m_dropped.load(std::memory_order_relaxed);
+    }
+
+    return rv;
+}
+
+
+void Trace::close()
+{
+    {
+	std::lock_guard<std::mutex> lck(m_mtx);
+	if(m_closed) {
+	    return;
+	}
+	m_closed = true;
+	m_stop = true;
+    }
+    m_cond.notify_one();
+    m_thread.join();
+
+    std::vector<std::uint8_t> end;
+    end.push_back(static_cast<std::uint8_t>(tracefile::Chunk::end));
+    put(end, m_written.load(), 8);
+    put(end, dropped(), 8);
+    m_file.write(reinterpret_cast<const char *>(end.data()), end.size());
+    m_file.close();
+}
+
+
+// collect(): write test cases pending, then the records of each ring, as one chunk per ring.
+// called with m_mtx held
+void Trace::collect(std::vector<trace_record_t> &records, std::vector<std::uint8_t> &chunk)
+{
+    if(!m_pending.empty()) {
+	m_file.write(reinterpret_cast<const char *>(m_pending.data()), m_pending.size());
+	m_pending.clear();
+    }
+
+    for(auto &ring: m_rings) {
+	records.clear();
+	ring->drain(records);
+
+	if(records.empty()) {
+	    continue;
+	}
+
+	std::vector<std::uint8_t> encoded;
+	std::int64_t previous = 0;
+	for(auto &record: records) {
+	    auto start = record.start - m_origin;
+	    put_varint(encoded, zigzag(start - previous));
+	    put_varint(encoded, static_cast<std::uint64_t>(std::max<std::int64_t>(record.end - record.start, 0)));
+	    put_varint(encoded, record.testcase);
+	    put_varint(encoded, record.session);
+	    put_varint(encoded, record.rc);
+	    put_varint(encoded, record.retries);
+	    previous = start;
+	}
+
+	chunk.clear();
+	chunk.push_back(static_cast<std::uint8_t>(tracefile::Chunk::records));
+	put(chunk, ring->m_worker, 4);
+	put(chunk, records.size(), 4);
+	put(chunk, encoded.size(), 4);
+	chunk.insert(chunk.end(), encoded.begin(), encoded.end());
+	m_file.write(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+	m_written += records.size();
+    }
+}
+
+
+void Trace::loop()
+{
+    std::vector<trace_record_t> records;
+    std::vector<std::uint8_t> chunk;
+    records.reserve(Ring::capacity);
+
+    std::unique_lock<std::mutex> lck(m_mtx);
+
+    while(!m_cond.wait_for(lck, m_poll, [this] { return m_stop; })) {
+	collect(records, chunk);
+    }
+
+    collect(records, chunk);	// whatever was pushed before stopping
+}
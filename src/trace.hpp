@@ -0,0 +1,157 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// trace.hpp: a binary trace of every PKCS#11 call, written in the background
+
+#if !defined(TRACE_H)
+#define TRACE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <fstream>
+
+struct TraceException : std::invalid_argument {
+    using std::invalid_argument::invalid_argument;
+};
+
+// trace file format. All integers are little-endian.
+// - header: magic, version, rank of the process, and the origin of the trace, on the steady clock and on the system clock (ns)
+// - then chunks, each starting with its kind:
+//   - testcase: id, vector size, length and name of a test case. Defined before any record referring to it
+//   - records: worker, number of records, size of the encoded records, then the records of a worker.
+//     each record is made of varints: start (delta from the previous start in the chunk, zigzag-encoded, the first from the origin),
+//     duration, test case, session handle, return code and retries. Times are in ns.
+//   - end: number of records written, and number of records dropped. Written when the trace is closed
+namespace tracefile {
+    constexpr char magic[8] = { 'P', '1', '1', 'T', 'R', 'A', 'C', 'E' };
+    constexpr std::uint32_t version = 1;
+    constexpr size_t header_size = sizeof(magic) + 4 + 4 + 8 + 8;
+
+    enum class Chunk : std::uint8_t { testcase = 1, records = 2, end = 3 };
+}
+
+// trace_record_t: a call, as pushed by a worker
+struct trace_record_t {
+    std::int64_t start;		// when the call started, on the steady clock, in ns
+    std::int64_t end;		// when the call completed, on the steady clock, in ns
+    std::uint64_t session;	// session handle
+    std::uint32_t testcase;	// test case, see Trace::testcase()
+    std::uint32_t rc;		// return code
+    std::uint32_t retries;	// number of retries
+};
+
+// workers bind themselves to the trace, and push a record per call into their own ring buffer,
+// without locking nor allocating. A collector thread wakes up regularly, drains the rings and writes the records.
+// when a ring is full, records are dropped and counted, rather than blocking the worker.
+class Trace
+{
+public:
+    // Ring: a single producer, single consumer ring buffer of records, one per worker thread
+    class Ring {
+	friend class Trace;
+	static constexpr size_t capacity = 1 << 16; // must be a power of two
+
+	std::vector<trace_record_t> m_records;
+	alignas(64) std::atomic<size_t> m_head { 0 }; // next record to push, written by the worker
+	alignas(64) std::atomic<size_t> m_tail { 0 }; // next record to pop, written by the collector
+	std::atomic<size_t> m_dropped { 0 };
+	Trace &m_trace;
+	const size_t m_worker;
+	const std::string m_arm;	// in A/B comparisons, the executor of the worker, see testcase()
+
+	// drain(): pop all records available, into out
+	void drain(std::vector<trace_record_t> &out);
+
+    public:
+	Ring(Trace &trace, size_t worker, const std::string &arm) : m_records(capacity), m_trace(trace), m_worker(worker), m_arm(arm) { }
+
+	inline Trace &trace() { return m_trace; }
+
+	// testcase(): see Trace::testcase(). When the worker belongs to an arm, the name of the test case is
+	// prefixed with it, so that calls of A and B, made by workers with the same index, are told apart
+	inline std::uint32_t testcase(const std::string &name, size_t vector) {
+	    return m_trace.testcase(m_arm.empty() ? name : m_arm + ": " + name, vector);
+	}
+
+	// push(): queue a record, or drop it if the ring is full
+	inline void push(const trace_record_t &record) {
+	    auto head = m_head.load(std::memory_order_relaxed);
+	    if(head - m_tail.load(std::memory_order_acquire) == capacity) {
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	    }
+	    m_records[head & (capacity - 1)] = record;
+	    m_head.store(head + 1, std::memory_order_release);
+	}
+    };
+
+    // the trace is written to path. The rank of the process is recorded in the header
+    Trace(const std::string &path, size_t rank = 0);
+    ~Trace();
+
+    Trace( const Trace &) = delete;
+    Trace& operator=( const Trace &) = delete;
+
+    // bind(): called by a worker thread, to be traced under its worker index, and its arm if any
+    void bind(size_t worker, const std::string &arm = "");
+
+    // current(): the ring of the calling thread, or nullptr if it is not bound to a trace
+    static Ring *current();
+
+    // testcase(): the identifier of a test case, given its name and vector size. Not meant for the hot loop
+    std::uint32_t testcase(const std::string &name, size_t vector);
+
+    // close(): stop the collector, write what is left and close the file. Called on destruction
+    void close();
+
+    inline const std::string &path() const { return m_path; }
+
+    // written(), dropped(): number of records written, and dropped as rings were full. Final once closed
+    inline size_t written() const { return m_written.load(); }
+    size_t dropped();
+
+private:
+    const std::string m_path;
+    const std::chrono::nanoseconds m_poll { std::chrono::milliseconds(10) };
+    std::ofstream m_file;
+    std::int64_t m_origin;	// steady clock, in ns, when the trace was opened
+    std::mutex m_mtx;
+    std::condition_variable m_cond;
+    bool m_stop { false };
+    bool m_closed { false };
+    std::vector<std::unique_ptr<Ring> > m_rings;		    // protected by m_mtx
+    std::map<std::pair<std::string, size_t>, std::uint32_t> m_testcases; // protected by m_mtx
+    std::vector<std::uint8_t> m_pending;			    // protected by m_mtx: test cases not written yet
+    std::atomic<size_t> m_written { 0 };
+    std::thread m_thread;
+
+    void loop();
+    void collect(std::vector<trace_record_t> &records, std::vector<std::uint8_t> &chunk);
+};
+
+#endif // TRACE_H
@@ -0,0 +1,173 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// tracereader.cpp: read a binary trace written with --trace
+
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "tracereader.hpp"
+
+// get(): read an integer of n bytes, little-endian
+static std::uint64_t get(const std::uint8_t *p, size_t n)
+{
+    std::uint64_t rv = 0;
+
+    for(size_t i=0; i<n; i++) {
+	rv |= static_cast<std::uint64_t>(p[i]) << (8*i);
+    }
+
+    return rv;
+}
+
+// get_varint(): read an integer, 7 bits per byte, least significant first
+static std::uint64_t get_varint(const std::uint8_t *&p, const std::uint8_t *end)
+{
+    std::uint64_t rv = 0;
+
+    for(unsigned shift=0; p<end && shift<64; shift+=7) {
+	auto byte = *p++;
+	rv |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+	if((byte & 0x80) == 0) {
+	    return rv;
+	}
+    }
+
+    throw TraceException("malformed record in trace");
+}
+
+// unzigzag(): see zigzag() in trace.cpp
+static inline std::int64_t unzigzag(std::uint64_t value)
+{
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+
+TraceReader::TraceReader(const std::string &path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+	throw TraceException("cannot open trace file " + path);
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < tracefile::header_size) {
+	::close(fd);
+	throw TraceException(path + " is not a trace file");
+    }
+
+    m_size = static_cast<size_t>(st.st_size);
+    void *area = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(area == MAP_FAILED) {
+	throw TraceException("cannot map trace file " + path);
+    }
+    m_data = static_cast<const std::uint8_t *>(area);
+
+    if(std::memcmp(m_data, tracefile::magic, sizeof(tracefile::magic)) != 0
+       || get(m_data + sizeof(tracefile::magic), 4) != tracefile::version) {
+	munmap(const_cast<std::uint8_t *>(m_data), m_size);
+	throw TraceException(path + " is not a trace file, or has an unsupported version");
+    }
+
+    auto p = m_data + sizeof(tracefile::magic) + 4;
+    m_rank = get(p, 4);
+    m_origin = static_cast<std::int64_t>(get(p + 4, 8));
+    m_realtime = static_cast<std::int64_t>(get(p + 12, 8));
+
+    // scan chunks, up to the end chunk, or to the last complete one
+    for(size_t offset = tracefile::header_size; offset < m_size; ) {
+	auto chunk = m_data + offset;
+	auto left = m_size - offset;
+
+	switch(static_cast<tracefile::Chunk>(chunk[0])) {
+	case tracefile::Chunk::testcase: {
+	    if(left < 13 || left < 13 + get(chunk + 9, 4)) {
+		return;
+	    }
+	    auto length = get(chunk + 9, 4);
+	    m_testcases[get(chunk + 1, 4)] = { std::string(reinterpret_cast<const char *>(chunk + 13), length), get(chunk + 5, 4) };
+	    offset += 13 + length;
+	    break;
+	}
+
+	case tracefile::Chunk::records:
+	    if(left < 13 || left < 13 + get(chunk + 9, 4)) {
+		return;
+	    }
+	    m_chunks.push_back(offset);
+	    offset += 13 + get(chunk + 9, 4);
+	    break;
+
+	case tracefile::Chunk::end:
+	    if(left >= 17) {
+		m_written = get(chunk + 1, 8);
+		m_dropped = get(chunk + 9, 8);
+		m_complete = true;
+	    }
+	    return;
+
+	default:
+	    return;		// garbage: the trace was not closed
+	}
+    }
+}
+
+
+TraceReader::~TraceReader()
+{
+    munmap(const_cast<std::uint8_t *>(m_data), m_size);
+}
+
+
+const std::pair<std::string, size_t> &TraceReader::testcase(std::uint32_t id) const
+{
+    auto it = m_testcases.find(id);
+
+    if(it == m_testcases.end()) {
+	throw TraceException("unknown test case " + std::to_string(id) + " in trace");
+    }
+
+    return it->second;
+}
+
+
+void TraceReader::for_each(const std::function<void(const trace_event_t &)> &f) const
+{
+    for(auto offset: m_chunks) {
+	auto chunk = m_data + offset;
+	auto p = chunk + 13;
+	auto end = p + get(chunk + 9, 4);
+	std::int64_t previous = 0;
+	trace_event_t event;
+
+	event.worker = get(chunk + 1, 4);
+	for(auto count = get(chunk + 5, 4); count > 0; count--) {
+	    event.start = previous + unzigzag(get_varint(p, end));
+	    event.end = event.start + static_cast<std::int64_t>(get_varint(p, end));
+	    event.testcase = static_cast<std::uint32_t>(get_varint(p, end));
+	    event.session = get_varint(p, end);
+	    event.rc = static_cast<std::uint32_t>(get_varint(p, end));
+	    event.retries = static_cast<std::uint32_t>(get_varint(p, end));
+	    previous = event.start;
+	    f(event);
+	}
+    }
+}
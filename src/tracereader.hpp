@@ -0,0 +1,82 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// tracereader.hpp: read a binary trace written with --trace
+
+#if !defined(TRACEREADER_H)
+#define TRACEREADER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include "trace.hpp"
+
+// trace_event_t: a call, as read from a trace
+struct trace_event_t {
+    size_t worker;		// worker index, within the process
+    std::int64_t start;		// when the call started, in ns since the origin of the trace
+    std::int64_t end;		// when the call completed, in ns since the origin of the trace
+    std::uint32_t testcase;	// test case, see TraceReader::testcase()
+    std::uint64_t session;	// session handle
+    std::uint32_t rc;		// return code
+    std::uint32_t retries;	// number of retries
+};
+
+// the trace file is mapped in memory, and scanned once when opened, for its test cases and chunks of records.
+// records are decoded on the fly by for_each(), in file order: ordered by start time for each worker,
+// but interleaved between workers. A trace that was not closed (e.g. the process was killed) is read up to its last complete chunk.
+class TraceReader
+{
+    const std::uint8_t *m_data { nullptr };
+    size_t m_size { 0 };
+    size_t m_rank;
+    std::int64_t m_origin;	// steady clock, in ns, when the trace was opened
+    std::int64_t m_realtime;	// system clock, in ns since the Unix epoch, when the trace was opened
+    std::map<std::uint32_t, std::pair<std::string, size_t> > m_testcases;
+    std::vector<size_t> m_chunks; // offset of each chunk of records
+    bool m_complete { false };
+    size_t m_written { 0 };
+    size_t m_dropped { 0 };
+
+public:
+    TraceReader(const std::string &path);
+    ~TraceReader();
+
+    TraceReader( const TraceReader &) = delete;
+    TraceReader& operator=( const TraceReader &) = delete;
+
+    inline size_t rank() const { return m_rank; }
+    inline std::int64_t origin() const { return m_origin; }
+    inline std::int64_t realtime() const { return m_realtime; }
+
+    // complete(): tells if the trace was closed properly. If so, written() and dropped() are known
+    inline bool complete() const { return m_complete; }
+    inline size_t written() const { return m_written; }
+    inline size_t dropped() const { return m_dropped; }
+
+    // testcase(): name and vector size of a test case
+    const std::pair<std::string, size_t> &testcase(std::uint32_t id) const;
+
+    // for_each(): call f on every record of the trace
+    void for_each(const std::function<void(const trace_event_t &)> &f) const;
+};
+
+#endif // TRACEREADER_H
@@ -0,0 +1,134 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// usl.cpp: fit of Gunther's Universal Scalability Law to throughput measures
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "usl.hpp"
+
+
+double USLFit::throughput(double n) const
+{
+    return lambda * n / ( 1 + sigma * (n-1) + kappa * n * (n-1) );
+}
+
+
+double USLFit::peak_concurrency() const
+{
+    if(kappa <= 0.0 || sigma >= 1.0) {
+	return std::numeric_limits<double>::infinity();
+    }
+
+    return std::sqrt( (1 - sigma) / kappa );
+}
+
+
+double USLFit::peak_throughput() const
+{
+    auto n = peak_concurrency();
+
+    if(std::isinf(n)) {
+	// no peak: throughput tends to lambda/sigma
+	return sigma > 0.0 ? lambda / sigma : std::numeric_limits<double>::infinity();
+    }
+
+    return throughput(n);
+}
+
+
+// reference: N. J. Gunther, "Guerrilla Capacity Planning", chapter 5.
+// The model is linearized by considering the relative capacity C(N) = X(N)/lambda:
+//
+//   N/C(N) - 1 = sigma * (N-1) + kappa * N * (N-1)
+//
+// which is a quadratic without intercept, solved with the normal equations.
+USLFit fit_usl(const std::vector<std::pair<double, double>> &measures)
+{
+    USLFit fit;
+
+    if(measures.size() < 3) {
+	return fit;
+    }
+
+    auto lowest = *std::min_element(measures.begin(), measures.end());
+
+    if(lowest.first <= 0.0 || lowest.second <= 0.0) {
+	return fit;
+    }
+
+    fit.lambda = lowest.second / lowest.first;
+
+    double sxx = 0.0, sxz = 0.0, szz = 0.0, sxy = 0.0, szy = 0.0;
+
+    for(auto &measure: measures) {
+	double n = measure.first;
+	double c = measure.second / fit.lambda;
+
+	if(c <= 0.0) {
+	    return fit;		// a null throughput cannot be fitted
+	}
+
+	double x = n - 1;
+	double z = n * (n - 1);
+	double y = n / c - 1;
+
+	sxx += x*x;
+	sxz += x*z;
+	szz += z*z;
+	sxy += x*y;
+	szy += z*y;
+    }
+
+    double det = sxx * szz - sxz * sxz;
+
+    if(std::fabs(det) < std::numeric_limits<double>::epsilon() * sxx * szz) {
+	return fit;		// all measures at the same level
+    }
+
+    fit.sigma = (sxy * szz - szy * sxz) / det;
+    fit.kappa = (szy * sxx - sxy * sxz) / det;
+
+    // coefficients cannot be negative; when one is, we fit the other one alone.
+    if(fit.sigma < 0.0) {
+	fit.sigma = 0.0;
+	fit.kappa = std::max(0.0, szy / szz);
+    } else if(fit.kappa < 0.0) {
+	fit.kappa = 0.0;
+	fit.sigma = std::max(0.0, sxy / sxx);
+    }
+
+    // compute coefficient of determination, on throughput
+    double mean = 0.0;
+    for(auto &measure: measures) {
+	mean += measure.second;
+    }
+    mean /= measures.size();
+
+    double ss_res = 0.0, ss_tot = 0.0;
+    for(auto &measure: measures) {
+	ss_res += std::pow(measure.second - fit.throughput(measure.first), 2);
+	ss_tot += std::pow(measure.second - mean, 2);
+    }
+
+    fit.r2 = ss_tot > 0.0 ? 1 - ss_res / ss_tot : 1.0;
+    fit.valid = true;
+
+    return fit;
+}
@@ -0,0 +1,56 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// usl.hpp: fit of Gunther's Universal Scalability Law to throughput measures
+
+#if !defined(USL_H)
+#define USL_H
+
+#include <vector>
+#include <utility>
+
+// The Universal Scalability Law models the throughput X reached with N concurrent clients:
+//
+//   X(N) = lambda * N / ( 1 + sigma * (N-1) + kappa * N * (N-1) )
+//
+// where lambda is the throughput of a single client, sigma the contention coefficient
+// (serialization on a shared resource) and kappa the coherency coefficient (crosstalk between clients).
+struct USLFit {
+    bool valid { false };	// false if there was not enough points to fit the model
+    double lambda { 0.0 };	// throughput with one client
+    double sigma { 0.0 };	// contention coefficient
+    double kappa { 0.0 };	// coherency coefficient
+    double r2 { 0.0 };		// coefficient of determination of the fit, on throughput
+
+    // throughput(): the throughput predicted by the model for n clients
+    double throughput(double n) const;
+
+    // peak_concurrency(): the number of clients for which throughput is maximal.
+    // it is infinite when kappa is null (throughput grows asymptotically)
+    double peak_concurrency() const;
+
+    // peak_throughput(): the throughput predicted at peak concurrency
+    double peak_throughput() const;
+};
+
+// fit_usl(): fits the USL to a set of (concurrency, throughput) measures, using linear least squares.
+// at least three distinct concurrency levels are needed. If a single client was measured,
+// it gives lambda directly; otherwise, lambda is extrapolated from the lowest concurrency level.
+USLFit fit_usl(const std::vector<std::pair<double, double>> &measures);
+
+#endif // USL_H
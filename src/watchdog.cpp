@@ -0,0 +1,118 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// watchdog.cpp: a thread that flags PKCS#11 calls stuck beyond a hard limit
+
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include "watchdog.hpp"
+
+// the entry of the current worker thread, set by bind()
+static thread_local Watchdog::Entry *current_entry = nullptr;
+
+
+void Watchdog::Entry::describe(const std::string &description)
+{
+    std::lock_guard<std::mutex> lck(m_mtx);
+    m_description = description;
+}
+
+
+// calls are checked ten times per limit, but no more often than every millisecond,
+// and no less often than every 100 milliseconds
+Watchdog::Watchdog(std::chrono::nanoseconds limit)
+    : m_limit(limit),
+      m_poll(std::clamp<std::chrono::nanoseconds>(limit / 10, std::chrono::milliseconds(1), std::chrono::milliseconds(100)))
+{
+    m_thread = std::thread(&Watchdog::loop, this);
+}
+
+
+Watchdog::~Watchdog()
+{
+    {
+	std::lock_guard<std::mutex> lck(m_mtx);
+	m_stop = true;
+    }
+    m_cond.notify_one();
+    m_thread.join();
+}
+
+
+void Watchdog::bind(size_t worker, const std::string &arm)
+{
+    std::lock_guard<std::mutex> lck(m_mtx);
+    m_entries.push_back(std::make_unique<Entry>(worker, arm));
+    current_entry = m_entries.back().get();
+}
+
+
+Watchdog::Entry *Watchdog::current()
+{
+    return current_entry;
+}
+
+
+std::string Watchdog::report()
+{
+    std::lock_guard<std::mutex> lck(m_mtx);
+    std::string rv;
+
+    for(auto &report: m_reports) {
+	rv += (rv.empty() ? "" : "; ") + report;
+    }
+
+    return rv;
+}
+
+
+void Watchdog::loop()
+{
+    std::unique_lock<std::mutex> lck(m_mtx);
+
+    while(!m_cond.wait_for(lck, m_poll, [this] { return m_stop; })) {
+	const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+
+	for(auto &entry: m_entries) {
+	    auto since = entry->m_since.load(std::memory_order_acquire);
+
+	    if(since == 0 || since == entry->m_flagged || now - since < m_limit.count()) {
+		continue;
+	    }
+
+	    entry->m_flagged = since;
+
+	    std::ostringstream report;
+	    {
+		std::lock_guard<std::mutex> lg(entry->m_mtx);
+		if(!entry->m_arm.empty()) {
+		    report << "arm " << entry->m_arm << ", ";
+		}
+		report << "thread " << entry->m_worker
+		       << ", session 0x" << std::hex << entry->m_session.load(std::memory_order_relaxed) << std::dec
+		       << ", " << entry->m_description
+		       << ": call in progress for more than " << std::chrono::duration<double>(m_limit).count() << " s";
+	    }
+
+	    std::cerr << "*** Watchdog: " << report.str() << std::endl;
+	    m_reports.push_back(report.str());
+	    m_stuck++;
+	}
+    }
+}
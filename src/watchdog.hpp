@@ -0,0 +1,122 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// watchdog.hpp: a thread that flags PKCS#11 calls stuck beyond a hard limit
+
+#if !defined(WATCHDOG_H)
+#define WATCHDOG_H
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <botan/p11_types.h>
+
+// a stuck call is a runtime failure of the token, not a usage error
+struct WatchdogException : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// workers bind themselves to the watchdog, and mark each call they make. The watchdog thread wakes up regularly,
+// and flags calls in progress for longer than the limit. A call stuck in the PKCS#11 library cannot be interrupted:
+// the executor gives up waiting for the worker instead, see Executor::dispatch().
+class Watchdog
+{
+public:
+    // Entry: the call in progress on a worker thread, if any
+    class Entry {
+	friend class Watchdog;
+	std::atomic<std::int64_t> m_since { 0 }; // when the call started, on the steady clock, in ns. 0 when idle
+	std::atomic<Botan::PKCS11::SessionHandle> m_session { 0 };
+	std::mutex m_mtx;
+	std::string m_description; // what the worker is executing, protected by m_mtx
+	std::int64_t m_flagged { 0 }; // start of the last call flagged, so that each call is flagged once
+	const size_t m_worker;
+	const std::string m_arm; // in A/B comparisons, the arm of the worker
+
+    public:
+	Entry(size_t worker, const std::string &arm) : m_worker(worker), m_arm(arm) { }
+
+	// describe(): set what the worker is executing, e.g. benchmark name and key label
+	void describe(const std::string &description);
+
+	inline void enter(Botan::PKCS11::SessionHandle session) {
+	    m_session.store(session, std::memory_order_relaxed);
+	    m_since.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_release);
+	}
+	inline void leave() { m_since.store(0, std::memory_order_release); }
+	// reopened(): the call in progress carries on, on a session opened in place of a lost one
+	inline void reopened(Botan::PKCS11::SessionHandle session) { m_session.store(session, std::memory_order_relaxed); }
+    };
+
+    // Call: marks a call in progress on the entry of the current thread, for the lifetime of the object.
+    // nothing is done when the thread is not bound to a watchdog.
+    class Call {
+	Entry *m_entry;
+
+    public:
+	Call(Botan::PKCS11::SessionHandle session) : m_entry(current()) { if(m_entry) m_entry->enter(session); }
+	~Call() { if(m_entry) m_entry->leave(); }
+
+	Call( const Call &) = delete;
+	Call& operator=( const Call &) = delete;
+    };
+
+    Watchdog(std::chrono::nanoseconds limit);
+    ~Watchdog();
+
+    Watchdog( const Watchdog &) = delete;
+    Watchdog& operator=( const Watchdog &) = delete;
+
+    // bind(): called by a worker thread, to be watched under its worker index, and its arm if any
+    void bind(size_t worker, const std::string &arm = "");
+
+    // current(): the entry of the calling thread, or nullptr if it is not bound to a watchdog
+    static Entry *current();
+
+    inline std::chrono::nanoseconds limit() const { return m_limit; }
+
+    // poll(): how often calls are checked
+    inline std::chrono::nanoseconds poll() const { return m_poll; }
+
+    // stuck(): the number of calls flagged so far
+    inline size_t stuck() const { return m_stuck.load(); }
+
+    // report(): a description of the calls flagged so far
+    std::string report();
+
+private:
+    const std::chrono::nanoseconds m_limit;
+    const std::chrono::nanoseconds m_poll;
+    std::mutex m_mtx;
+    std::condition_variable m_cond;
+    bool m_stop { false };
+    std::vector<std::unique_ptr<Entry> > m_entries; // protected by m_mtx
+    std::vector<std::string> m_reports;		   // protected by m_mtx
+    std::atomic<size_t> m_stuck { 0 };
+    std::thread m_thread;
+
+    void loop();
+};
+
+#endif // WATCHDOG_H
@@ -0,0 +1,117 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// workerpool.cpp: a pool of long-lived worker threads, each bound to its sessions
+
+#include "workerpool.hpp"
+
+
+WorkerPool::WorkerPool( std::vector<std::unique_ptr<Session> > &sessions, size_t sessions_per_worker, bool session_keys, const Placement &placement, Watchdog *watchdog, Trace *trace, const std::string &arm )
+    : m_placement(placement),
+      m_watchdog(watchdog),
+      m_trace(trace),
+      m_arm(arm)
+{
+    // worker th is bound to sessions th*sessions_per_worker to (th+1)*sessions_per_worker-1
+    for(size_t th=0; th<sessions.size()/sessions_per_worker; th++) {
+	auto worker = std::make_unique<Worker>();
+	for(size_t k=0; k<sessions_per_worker; k++) {
+	    worker->sessions.push_back(sessions[th*sessions_per_worker+k].get());
+	}
+	worker->threadindex = session_keys ? std::optional<size_t>(th) : std::nullopt;
+	m_workers.push_back(std::move(worker));
+    }
+
+    // threads are started once all workers are constructed,
+    // and we wait until they have all applied their placement
+    m_startline.reset(m_workers.size()+1);
+    for(size_t th=0; th<m_workers.size(); th++) {
+	m_workers[th]->thread = std::thread(&WorkerPool::loop, this, std::ref(*m_workers[th]), th);
+    }
+    m_startline.arrive_and_wait();
+}
+
+
+WorkerPool::~WorkerPool()
+{
+    for(auto &worker: m_workers) {
+	{
+	    std::lock_guard<std::mutex> lck(worker->mtx);
+	    worker->stop = true;
+	}
+	worker->cond.notify_one();
+    }
+
+    for(auto &worker: m_workers) {
+	worker->thread.join();
+    }
+}
+
+
+std::future<benchmark_result_t> WorkerPool::submit( size_t worker, task_t task )
+{
+    auto &w = *m_workers.at(worker);
+    WorkItem item { std::move(task), std::promise<benchmark_result_t>() };
+    auto rv = item.result.get_future();
+
+    {
+	std::lock_guard<std::mutex> lck(w.mtx);
+	w.queue.push_back(std::move(item));
+    }
+    w.cond.notify_one();
+
+    return rv;
+}
+
+
+void WorkerPool::loop(Worker &worker, size_t th)
+{
+    if(m_placement.enabled()) {
+	worker.placement = m_placement.apply(th);
+    }
+    if(m_watchdog) {
+	m_watchdog->bind(th, m_arm);
+    }
+    if(m_trace) {
+	m_trace->bind(th, m_arm);
+    }
+    m_startline.arrive();
+
+    for(;;) {
+	WorkItem item;
+
+	{
+	    std::unique_lock<std::mutex> lck(worker.mtx);
+	    worker.cond.wait(lck, [&worker] { return worker.stop || !worker.queue.empty(); });
+
+	    if(worker.queue.empty()) {
+		return;		// stop requested, and nothing left to do
+	    }
+
+	    item = std::move(worker.queue.front());
+	    worker.queue.pop_front();
+	}
+
+	try {
+	    item.result.set_value(item.task(worker.sessions, worker.threadindex, m_startline));
+	} catch (...) {
+	    // the exception is rethrown to the submitter, when getting the result
+	    item.result.set_exception(std::current_exception());
+	}
+    }
+}
@@ -0,0 +1,99 @@
+// -*- mode: c++; c-file-style:"stroustrup"; -*-
+
+//
+// Copyright (c) 2026 Mastercard
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// workerpool.hpp: a pool of long-lived worker threads, each bound to its sessions
+
+#if !defined(WORKERPOOL_H)
+#define WORKERPOOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <botan/p11_types.h>
+#include "p11benchmark.hpp"
+#include "barrier.hpp"
+#include "placement.hpp"
+#include "watchdog.hpp"
+#include "trace.hpp"
+
+using namespace Botan::PKCS11;
+
+// task_t: what a worker executes, given its sessions, its thread index (if session keys are used) and the start line
+using task_t = std::function<benchmark_result_t(const std::vector<Session *> &, std::optional<size_t>, Barrier &)>;
+
+// WorkItem: a task to execute by a worker
+struct WorkItem {
+    task_t task;
+    std::promise<benchmark_result_t> result;  // where to deliver the result
+};
+
+class WorkerPool
+{
+    // each worker has its own queue, as it is bound to a session
+    struct Worker {
+	std::vector<Session *> sessions;
+	std::optional<size_t> threadindex;
+	std::string placement;	// placement and scheduling actually applied to the thread
+	std::mutex mtx;
+	std::condition_variable cond;
+	std::deque<WorkItem> queue;
+	bool stop { false };
+	std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker> > m_workers;
+    Barrier m_startline;
+    const Placement &m_placement;
+    Watchdog *m_watchdog;	// if any, workers bind to it, so their calls are watched
+    Trace *m_trace;		// if any, workers bind to it, so their calls are traced
+    const std::string m_arm;	// in A/B comparisons, the arm workers are watched and traced under
+
+    void loop(Worker &worker, size_t th);
+
+public:
+    // one worker is created per group of sessions_per_worker sessions.
+    // if session_keys is true, workers use keys generated for their index.
+    // each worker applies the placement to its own thread, before any memory is touched by benchmarks
+    WorkerPool( std::vector<std::unique_ptr<Session> > &sessions, size_t sessions_per_worker, bool session_keys, const Placement &placement, Watchdog *watchdog = nullptr, Trace *trace = nullptr, const std::string &arm = "" );
+    ~WorkerPool();
+
+    WorkerPool( const WorkerPool &) = delete;
+    WorkerPool& operator=( const WorkerPool &) = delete;
+
+    WorkerPool( WorkerPool &&) = delete;
+    WorkerPool& operator=( WorkerPool &&) = delete;
+
+    inline size_t size() const { return m_workers.size(); }
+
+    // startline(): the barrier where workers wait before executing iterations
+    inline Barrier &startline() { return m_startline; }
+
+    // placement(): the placement and scheduling actually applied to a worker
+    inline const std::string &placement(size_t worker) const { return m_workers.at(worker)->placement; }
+
+    // submit(): queue a task to a worker
+    std::future<benchmark_result_t> submit( size_t worker, task_t task );
+};
+
+#endif // WORKERPOOL_H